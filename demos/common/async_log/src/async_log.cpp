@@ -0,0 +1,503 @@
+#include "async_log.h"
+
+#include <pthread.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <charconv>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+
+namespace async_log {
+
+namespace {
+
+constexpr int kCrashSignals[] = {SIGSEGV, SIGBUS, SIGABRT, SIGFPE, SIGILL};
+constexpr std::size_t kMinRingBytes = 4096;
+// 每个环最多贡献两段（绕回时），总数远低于 IOV_MAX。
+constexpr int kMaxIov = kMaxThreads * 2;
+// 崩溃 flush 等写线程交出消费权的轮数；超时就直接接管，宁可重复几行也不丢。
+constexpr int kCrashFlushSpins = 1000;
+
+enum RingState : int {
+  kOwned,
+  // 所属线程已退出；写空之后可以交给新线程复用。
+  kOrphaned,
+};
+
+int SignalIndex(int sig) {
+  for (int i = 0; i < 5; ++i) {
+    if (kCrashSignals[i] == sig) {
+      return i;
+    }
+  }
+  return -1;
+}
+
+std::size_t RoundUpPow2(std::size_t value) {
+  std::size_t result = kMinRingBytes;
+  while (result < value) {
+    result <<= 1;
+  }
+  return result;
+}
+
+// 写满为止；EINTR 重试，其他错误放弃（日志不应让调用方失败）。
+void WriteAll(int fd, const char* data, std::size_t size) {
+  while (size > 0) {
+    const ssize_t n = ::write(fd, data, size);
+    if (n < 0 && errno == EINTR) {
+      continue;
+    }
+    if (n <= 0) {
+      return;
+    }
+    data += n;
+    size -= static_cast<std::size_t>(n);
+  }
+}
+
+// 处理部分写：跳过已写出的 iovec，截短写了一半的那个。
+std::size_t WriteVector(int fd, iovec* iov, int count) {
+  std::size_t total = 0;
+  while (count > 0) {
+    const ssize_t n = ::writev(fd, iov, count);
+    if (n < 0 && errno == EINTR) {
+      continue;
+    }
+    if (n <= 0) {
+      break;
+    }
+    total += static_cast<std::size_t>(n);
+    auto left = static_cast<std::size_t>(n);
+    while (count > 0 && left >= iov->iov_len) {
+      left -= iov->iov_len;
+      ++iov;
+      --count;
+    }
+    if (count > 0) {
+      iov->iov_base = static_cast<char*>(iov->iov_base) + left;
+      iov->iov_len -= left;
+    }
+  }
+  return total;
+}
+
+void Bump(std::atomic<std::uint64_t>& counter) {
+  counter.store(counter.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+}
+
+}  // namespace
+
+/*
+ * 单生产者（所属线程）/单消费者（写线程或崩溃 flush）字节环。
+ * head/tail 单调递增，取模靠 mask；生产者只写 head，消费者只写 tail，各占一条缓存行。
+ */
+struct Logger::Ring {
+  explicit Ring(std::size_t capacity)
+      : data(new char[capacity]), capacity(capacity), mask(capacity - 1) {}
+
+  alignas(64) std::atomic<std::uint64_t> head{0};
+  // 只有所属线程写入：relaxed load + store。
+  std::atomic<std::uint64_t> lines{0};
+  std::atomic<std::uint64_t> dropped{0};
+  alignas(64) std::atomic<std::uint64_t> tail{0};
+  alignas(64) std::atomic<int> state{kOwned};
+  std::unique_ptr<char[]> data;
+  const std::size_t capacity;
+  const std::size_t mask;
+};
+
+namespace {
+
+// 线程退出时把环标成孤儿；环本身不释放，写线程可能还没写完它。
+struct RingHandle {
+  std::atomic<int>* state = nullptr;
+  void* ring = nullptr;
+
+  ~RingHandle() {
+    if (state != nullptr) {
+      state->store(kOrphaned, std::memory_order_release);
+    }
+  }
+};
+
+thread_local RingHandle t_ring;
+
+}  // namespace
+
+Logger& Logger::Instance() {
+  // 故意不释放：atexit、线程退出与崩溃 handler 都可能在静态析构之后用到它。
+  static Logger* instance = new Logger();
+  return *instance;
+}
+
+bool Logger::Start(const LoggerOptions& options, std::string& error) {
+  if (running()) {
+    error = "logger already started";
+    return false;
+  }
+  if (options.fd < 0 || options.idle_wait_ms <= 0) {
+    error = "invalid logger options";
+    return false;
+  }
+  options_ = options;
+  ring_bytes_ = RoundUpPow2(options.ring_bytes);
+
+  static std::once_flag once;
+  std::call_once(once, [] {
+    ::pthread_atfork(nullptr, nullptr, &Logger::OnForkChild);
+    // main 返回或 exit() 时写出剩余内容。
+    std::atexit([] { Logger::Instance().Stop(); });
+  });
+
+  // 写线程默认屏蔽所有信号（继承自创建时的掩码），进程级信号不会落到它身上，
+  // 应用原有的 pause()/sigwait 式主循环不受影响；只放行调用方显式列出的信号。
+  sigset_t blocked;
+  sigset_t previous;
+  sigfillset(&blocked);
+  for (const int sig : options.deliverable_signals) {
+    sigdelset(&blocked, sig);
+  }
+  ::pthread_sigmask(SIG_BLOCK, &blocked, &previous);
+  stop_requested_.store(false, std::memory_order_relaxed);
+  writer_ = std::make_unique<std::thread>([this] { WriterLoop(); });
+  ::pthread_sigmask(SIG_SETMASK, &previous, nullptr);
+  running_.store(true, std::memory_order_release);
+  return true;
+}
+
+void Logger::Stop() {
+  if (!running() || writer_ == nullptr) {
+    return;
+  }
+  stop_requested_.store(true, std::memory_order_release);
+  {
+    std::lock_guard<std::mutex> lock(wake_mu_);
+    wake_cv_.notify_one();
+  }
+  writer_->join();
+  writer_.reset();
+  running_.store(false, std::memory_order_release);
+  // 写线程退出后、running_ 翻转前提交的行。
+  Drain();
+}
+
+void Logger::Flush() {
+  if (!running()) {
+    return;
+  }
+  std::uint64_t targets[kMaxThreads] = {};
+  const int count = ring_count_.load(std::memory_order_acquire);
+  for (int i = 0; i < count; ++i) {
+    const Ring* ring = rings_[i].load(std::memory_order_acquire);
+    targets[i] = ring != nullptr ? ring->head.load(std::memory_order_acquire) : 0;
+  }
+  for (int i = 0; i < count; ++i) {
+    const Ring* ring = rings_[i].load(std::memory_order_acquire);
+    while (ring != nullptr && ring->tail.load(std::memory_order_acquire) < targets[i] &&
+           running()) {
+      WakeWriter();
+      std::this_thread::yield();
+    }
+  }
+}
+
+bool Logger::InstallCrashFlush(std::string& error) {
+  if (crash_flush_installed_) {
+    return true;
+  }
+  // 与 crash_reporter 一样屏蔽其他崩溃信号，并在 sigaltstack 上运行（如果线程准备了的话）。
+  struct sigaction action {};
+  action.sa_sigaction = &Logger::OnCrashSignal;
+  action.sa_flags = SA_SIGINFO | SA_ONSTACK;
+  sigemptyset(&action.sa_mask);
+  for (const int sig : kCrashSignals) {
+    sigaddset(&action.sa_mask, sig);
+  }
+  for (int i = 0; i < 5; ++i) {
+    if (::sigaction(kCrashSignals[i], &action, &previous_actions_[i]) != 0) {
+      error = std::string("sigaction: ") + std::strerror(errno);
+      return false;
+    }
+  }
+  crash_flush_installed_ = true;
+  return true;
+}
+
+void Logger::OnCrashSignal(int sig, siginfo_t* info, void* /*ucontext*/) {
+  Logger& logger = Instance();
+  logger.FlushFromSignalHandler();
+
+  // 交还原处理方式（默认动作或先前安装的 handler）：硬件异常返回后会在同一条指令上再次触发，
+  // abort()/kill 这类主动发送的信号需要再发一次（当前被屏蔽，返回后送达）。
+  const int index = SignalIndex(sig);
+  if (index >= 0) {
+    ::sigaction(sig, &logger.previous_actions_[index], nullptr);
+  }
+  if (info == nullptr || info->si_code <= 0) {
+    ::raise(sig);
+  }
+}
+
+void Logger::FlushFromSignalHandler() {
+  for (int i = 0; i < kCrashFlushSpins && draining_.exchange(true, std::memory_order_acquire);
+       ++i) {
+    ::sched_yield();
+  }
+  DrainOwned();
+  draining_.store(false, std::memory_order_release);
+}
+
+void Logger::OnForkChild() {
+  Logger& logger = Instance();
+  if (!logger.running()) {
+    return;
+  }
+  // 子进程里写线程不存在：std::thread 对象既不能 join 也不能析构，只能放弃。
+  static_cast<void>(logger.writer_.release());
+  logger.running_.store(false, std::memory_order_relaxed);
+  logger.draining_.store(false, std::memory_order_relaxed);
+  logger.writer_idle_.store(false, std::memory_order_relaxed);
+  const int count = logger.ring_count_.load(std::memory_order_relaxed);
+  for (int i = 0; i < count; ++i) {
+    Ring* ring = logger.rings_[i].load(std::memory_order_relaxed);
+    if (ring != nullptr) {
+      ring->tail.store(ring->head.load(std::memory_order_relaxed), std::memory_order_relaxed);
+    }
+  }
+}
+
+void Logger::Write(const char* data, std::size_t size) {
+  if (!running()) {
+    WriteSync(data, size);
+    return;
+  }
+  Ring* ring = CurrentRing();
+  if (ring == nullptr || size > ring->capacity) {
+    WriteSync(data, size);
+    return;
+  }
+
+  const std::uint64_t head = ring->head.load(std::memory_order_relaxed);
+  while (ring->capacity - (head - ring->tail.load(std::memory_order_acquire)) < size) {
+    if (options_.overflow == OverflowPolicy::kDrop) {
+      Bump(ring->dropped);
+      return;
+    }
+    if (!running()) {
+      WriteSync(data, size);
+      return;
+    }
+    WakeWriter();
+    std::this_thread::yield();
+  }
+
+  const std::size_t offset = head & ring->mask;
+  const std::size_t first = std::min(size, ring->capacity - offset);
+  std::memcpy(ring->data.get() + offset, data, first);
+  std::memcpy(ring->data.get(), data + first, size - first);
+  ring->head.store(head + size, std::memory_order_release);
+  Bump(ring->lines);
+
+  // 与 WriterLoop 里 writer_idle_ 的设置配对：要么写线程看到新的 head，要么这里看到它在休眠。
+  std::atomic_thread_fence(std::memory_order_seq_cst);
+  if (writer_idle_.load(std::memory_order_relaxed)) {
+    WakeWriter();
+  }
+}
+
+LoggerStats Logger::Stats() const {
+  LoggerStats stats;
+  const int count = ring_count_.load(std::memory_order_acquire);
+  for (int i = 0; i < count; ++i) {
+    const Ring* ring = rings_[i].load(std::memory_order_acquire);
+    if (ring != nullptr) {
+      stats.lines += ring->lines.load(std::memory_order_relaxed);
+      stats.dropped += ring->dropped.load(std::memory_order_relaxed);
+    }
+  }
+  stats.bytes_written = bytes_written_.load(std::memory_order_relaxed);
+  stats.writev_calls = writev_calls_.load(std::memory_order_relaxed);
+  stats.sync_lines = sync_lines_.load(std::memory_order_relaxed);
+  return stats;
+}
+
+Logger::Ring* Logger::CurrentRing() {
+  if (t_ring.ring == nullptr) {
+    Ring* ring = ClaimRing();
+    if (ring == nullptr) {
+      return nullptr;
+    }
+    t_ring.ring = ring;
+    t_ring.state = &ring->state;
+  }
+  return static_cast<Ring*>(t_ring.ring);
+}
+
+Logger::Ring* Logger::ClaimRing() {
+  // 优先复用已退出线程留下、且已经写空的环。
+  const int count = ring_count_.load(std::memory_order_acquire);
+  for (int i = 0; i < count; ++i) {
+    Ring* ring = rings_[i].load(std::memory_order_acquire);
+    int expected = kOrphaned;
+    if (ring != nullptr &&
+        ring->head.load(std::memory_order_relaxed) ==
+            ring->tail.load(std::memory_order_acquire) &&
+        ring->state.compare_exchange_strong(expected, kOwned, std::memory_order_acq_rel)) {
+      return ring;
+    }
+  }
+
+  // 新建环只发生在线程第一次写日志时，这里加锁不影响热路径。
+  std::lock_guard<std::mutex> lock(claim_mu_);
+  const int index = ring_count_.load(std::memory_order_relaxed);
+  if (index >= kMaxThreads) {
+    return nullptr;
+  }
+  auto* ring = new Ring(ring_bytes_);
+  rings_[index].store(ring, std::memory_order_release);
+  ring_count_.store(index + 1, std::memory_order_release);
+  return ring;
+}
+
+void Logger::WriteSync(const char* data, std::size_t size) {
+  WriteAll(options_.fd, data, size);
+  sync_lines_.fetch_add(1, std::memory_order_relaxed);
+}
+
+void Logger::WakeWriter() {
+  if (writer_idle_.exchange(false, std::memory_order_acq_rel)) {
+    std::lock_guard<std::mutex> lock(wake_mu_);
+    wake_cv_.notify_one();
+  }
+}
+
+void Logger::WriterLoop() {
+  const auto idle_wait = std::chrono::milliseconds(options_.idle_wait_ms);
+  for (;;) {
+    const bool stopping = stop_requested_.load(std::memory_order_acquire);
+    if (Drain() > 0) {
+      continue;
+    }
+    if (stopping) {
+      return;
+    }
+    std::unique_lock<std::mutex> lock(wake_mu_);
+    writer_idle_.store(true, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (!HasPending() && !stop_requested_.load(std::memory_order_acquire)) {
+      wake_cv_.wait_for(lock, idle_wait);
+    }
+    writer_idle_.store(false, std::memory_order_relaxed);
+  }
+}
+
+bool Logger::HasPending() const {
+  const int count = ring_count_.load(std::memory_order_acquire);
+  for (int i = 0; i < count; ++i) {
+    const Ring* ring = rings_[i].load(std::memory_order_acquire);
+    if (ring != nullptr && ring->head.load(std::memory_order_acquire) !=
+                               ring->tail.load(std::memory_order_relaxed)) {
+      return true;
+    }
+  }
+  return false;
+}
+
+std::size_t Logger::Drain() {
+  if (draining_.exchange(true, std::memory_order_acquire)) {
+    return 0;
+  }
+  const std::size_t written = DrainOwned();
+  draining_.store(false, std::memory_order_release);
+  return written;
+}
+
+std::size_t Logger::DrainOwned() {
+  iovec iov[kMaxIov];
+  Ring* drained[kMaxThreads];
+  std::uint64_t heads[kMaxThreads];
+  int iov_count = 0;
+  int ring_total = 0;
+
+  const int count = ring_count_.load(std::memory_order_acquire);
+  for (int i = 0; i < count; ++i) {
+    Ring* ring = rings_[i].load(std::memory_order_acquire);
+    if (ring == nullptr) {
+      continue;
+    }
+    const std::uint64_t tail = ring->tail.load(std::memory_order_relaxed);
+    const std::uint64_t head = ring->head.load(std::memory_order_acquire);
+    if (head == tail) {
+      continue;
+    }
+    const std::size_t offset = tail & ring->mask;
+    const std::size_t size = head - tail;
+    const std::size_t first = std::min(size, ring->capacity - offset);
+    iov[iov_count++] = {ring->data.get() + offset, first};
+    if (first < size) {
+      iov[iov_count++] = {ring->data.get(), size - first};
+    }
+    drained[ring_total] = ring;
+    heads[ring_total] = head;
+    ++ring_total;
+  }
+  if (iov_count == 0) {
+    return 0;
+  }
+
+  const std::size_t written = WriteVector(options_.fd, iov, iov_count);
+  // 写失败（例如对端关闭）也推进 tail：日志宁可丢，也不能让生产者永远等空间。
+  for (int i = 0; i < ring_total; ++i) {
+    drained[i]->tail.store(heads[i], std::memory_order_release);
+  }
+  bytes_written_.fetch_add(written, std::memory_order_relaxed);
+  writev_calls_.fetch_add(1, std::memory_order_relaxed);
+  return written;
+}
+
+LogLine::~LogLine() {
+  buf_[size_++] = '\n';
+  Logger::Instance().Write(buf_, size_);
+}
+
+LogLine& LogLine::operator<<(std::string_view text) {
+  const std::size_t room = sizeof(buf_) - 1 - size_;
+  const std::size_t n = std::min(room, text.size());
+  std::memcpy(buf_ + size_, text.data(), n);
+  size_ += n;
+  return *this;
+}
+
+LogLine& LogLine::operator<<(char c) {
+  if (size_ + 1 < sizeof(buf_)) {
+    buf_[size_++] = c;
+  }
+  return *this;
+}
+
+LogLine& LogLine::operator<<(Hex hex) {
+  char digits[2 + 16];
+  digits[0] = '0';
+  digits[1] = 'x';
+  const auto result = std::to_chars(digits + 2, digits + sizeof(digits), hex.value, 16);
+  return *this << std::string_view(digits, static_cast<std::size_t>(result.ptr - digits));
+}
+
+LogLine& LogLine::AppendSigned(long long value) {
+  char digits[24];
+  const auto result = std::to_chars(digits, digits + sizeof(digits), value);
+  return *this << std::string_view(digits, static_cast<std::size_t>(result.ptr - digits));
+}
+
+LogLine& LogLine::AppendUnsigned(unsigned long long value) {
+  char digits[24];
+  const auto result = std::to_chars(digits, digits + sizeof(digits), value);
+  return *this << std::string_view(digits, static_cast<std::size_t>(result.ptr - digits));
+}
+
+}  // namespace async_log
@@ -0,0 +1,172 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+#include <csignal>
+
+namespace async_log {
+
+constexpr int kMaxThreads = 64;
+// 单行上限（含换行），超出部分截断。
+constexpr std::size_t kMaxLineBytes = 512;
+
+enum class OverflowPolicy {
+  // 本线程的环写满时让出 CPU，等写线程腾出空间：不丢日志，但调用方可能被拖慢。
+  kBlock,
+  // 环写满时丢弃这一行并计数：调用方耗时有上界。
+  kDrop,
+};
+
+struct LoggerOptions {
+  int fd = 1;
+  // 每个线程一个环形缓冲，容量向上取 2 的幂；只对 Start() 之后新建的环生效。
+  std::size_t ring_bytes = 64u << 10;
+  OverflowPolicy overflow = OverflowPolicy::kBlock;
+  // 写线程空闲时的最长休眠；正常情况下由生产者唤醒，这个上限只兜底丢失的唤醒。
+  int idle_wait_ms = 100;
+  // 写线程上保持可送达的信号；默认全部屏蔽，进程级信号只会落到应用自己的线程。
+  // 会用 tgkill 逐线程发信号的组件（如 crash reporter 的抓取信号）需要显式列在这里。
+  std::vector<int> deliverable_signals;
+};
+
+struct LoggerStats {
+  std::uint64_t lines = 0;
+  std::uint64_t dropped = 0;
+  std::uint64_t bytes_written = 0;
+  std::uint64_t writev_calls = 0;
+  // 未启动、环用尽或单行超过环容量时退回同步 write 的行数。
+  std::uint64_t sync_lines = 0;
+};
+
+/*
+ * 进程级异步日志：取代每行一次 flush 的 `std::cout << ... << std::endl`。
+ * - 生产者把整行格式化在栈上（LogLine），再拷进本线程独占的字节环并发布 head，
+ *   整个过程不加锁、不进内核；只有写线程正在休眠时，才由第一个生产者唤醒它一次。
+ * - 写线程把所有线程环里已发布的内容收集成 iovec，一次 writev 写出。
+ *   同一线程内的行保持顺序，不同线程之间不保证先后。
+ * - InstallCrashFlush() 在崩溃信号里把环中剩余内容直接写出，再交还原来的处理方式，
+ *   崩溃前最后几行不会随进程一起丢失；与 crash_reporter 等其他 handler 的安装顺序无关。
+ * - 未 Start()（或已 Stop()）时 LogLine 退回同步 write，行为与逐行 flush 一致。
+ * - fork 出的子进程里没有写线程：子进程丢弃继承来的未写内容，之后退回同步 write。
+ */
+class Logger final {
+ public:
+  static Logger& Instance();
+
+  bool Start(const LoggerOptions& options, std::string& error);
+
+  // 写出已提交的行并结束写线程。调用前应先停掉其他仍在写日志的线程。
+  void Stop();
+
+  // 阻塞到调用前已提交的行全部写出；与 std::cout 混用时，切换前调用一次保持顺序。
+  void Flush();
+
+  // 为 SIGSEGV / SIGBUS / SIGABRT / SIGFPE / SIGILL 安装 flush handler。
+  bool InstallCrashFlush(std::string& error);
+
+  // 异步信号安全：只用原子操作与 writev。
+  void FlushFromSignalHandler();
+
+  // 提交一段完整内容（通常是带换行的一行），不会与其他线程的内容交错。
+  void Write(const char* data, std::size_t size);
+
+  bool running() const { return running_.load(std::memory_order_acquire); }
+
+  LoggerStats Stats() const;
+
+ private:
+  struct Ring;
+
+  Logger() = default;
+  Logger(const Logger&) = delete;
+  Logger& operator=(const Logger&) = delete;
+
+  static void OnCrashSignal(int sig, siginfo_t* info, void* ucontext);
+  static void OnForkChild();
+
+  Ring* CurrentRing();
+  Ring* ClaimRing();
+  void WriteSync(const char* data, std::size_t size);
+  void WakeWriter();
+  void WriterLoop();
+  bool HasPending() const;
+  // 调用方必须持有消费权（draining_）。返回写出的字节数。
+  std::size_t DrainOwned();
+  std::size_t Drain();
+
+  LoggerOptions options_;
+  std::size_t ring_bytes_ = 0;
+
+  std::atomic<bool> running_{false};
+  std::atomic<bool> stop_requested_{false};
+  std::atomic<bool> writer_idle_{false};
+  std::atomic<bool> draining_{false};
+  std::atomic<int> ring_count_{0};
+  std::atomic<Ring*> rings_[kMaxThreads] = {};
+
+  std::atomic<std::uint64_t> bytes_written_{0};
+  std::atomic<std::uint64_t> writev_calls_{0};
+  std::atomic<std::uint64_t> sync_lines_{0};
+
+  std::mutex claim_mu_;
+  std::mutex wake_mu_;
+  std::condition_variable wake_cv_;
+  std::unique_ptr<std::thread> writer_;
+
+  bool crash_flush_installed_ = false;
+  struct sigaction previous_actions_[5] {};
+};
+
+// 十六进制输出（带 0x 前缀）。
+struct Hex {
+  std::uint64_t value;
+};
+
+/*
+ * 在栈上拼一行，析构时追加换行并整行提交给 Logger：
+ *   async_log::LogLine() << "[B] dtor: demo starts";
+ */
+class LogLine final {
+ public:
+  LogLine() = default;
+  LogLine(const LogLine&) = delete;
+  LogLine& operator=(const LogLine&) = delete;
+  ~LogLine();
+
+  LogLine& operator<<(std::string_view text);
+  LogLine& operator<<(const char* text) { return *this << std::string_view(text); }
+  LogLine& operator<<(const std::string& text) { return *this << std::string_view(text); }
+  LogLine& operator<<(char c);
+  LogLine& operator<<(Hex hex);
+
+  template <typename T,
+            typename std::enable_if<std::is_integral<T>::value && !std::is_same<T, char>::value &&
+                                        !std::is_same<T, bool>::value,
+                                    int>::type = 0>
+  LogLine& operator<<(T value) {
+    if (std::is_signed<T>::value) {
+      return AppendSigned(static_cast<long long>(value));
+    }
+    return AppendUnsigned(static_cast<unsigned long long>(value));
+  }
+
+ private:
+  LogLine& AppendSigned(long long value);
+  LogLine& AppendUnsigned(unsigned long long value);
+
+  // 最后一个字节留给换行。
+  char buf_[kMaxLineBytes];
+  std::size_t size_ = 0;
+};
+
+}  // namespace async_log
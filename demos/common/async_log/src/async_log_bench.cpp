@@ -0,0 +1,234 @@
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "async_log.h"
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+enum class Sink {
+  // 现状：共享 ostream 加锁，每行 std::endl（一次 flush = 一次 write）。
+  kIostreamEndl,
+  // 同样加锁，但用 '\n'，交给 filebuf 缓冲。
+  kIostreamBuffered,
+  kAsyncBlock,
+  kAsyncDrop,
+};
+
+struct BenchCase {
+  const char* name;
+  Sink sink;
+};
+
+constexpr BenchCase kCases[] = {
+    {"iostream + std::endl", Sink::kIostreamEndl},
+    {"iostream + '\\n'", Sink::kIostreamBuffered},
+    {"async_log (block)", Sink::kAsyncBlock},
+    {"async_log (drop)", Sink::kAsyncDrop},
+};
+
+struct BenchConfig {
+  int lines = 200000;
+  int threads = 1;
+  std::string path = "async_log_bench.out";
+};
+
+struct CaseResult {
+  // 从第一行开始到最后一行写进内核（含 flush / 写线程追完）为止。
+  double seconds = 0;
+  std::vector<std::uint32_t> latencies_ns;
+  async_log::LoggerStats stats;
+  std::uint64_t file_bytes = 0;
+};
+
+std::uint32_t Percentile(const std::vector<std::uint32_t>& sorted, double p) {
+  if (sorted.empty()) {
+    return 0;
+  }
+  const auto index = static_cast<std::size_t>(p / 100.0 * static_cast<double>(sorted.size() - 1));
+  return sorted[index];
+}
+
+std::uint32_t ElapsedNs(Clock::time_point begin, Clock::time_point end) {
+  return static_cast<std::uint32_t>(
+      std::chrono::duration_cast<std::chrono::nanoseconds>(end - begin).count());
+}
+
+// 每个线程写 lines 行，内容与 demo 里的日志长度相近；逐次计时，记录每次调用的耗时。
+void ProduceIostream(std::ostream& out, std::mutex& mu, bool endl, int thread_id, int lines,
+                     std::vector<std::uint32_t>& latencies) {
+  for (int i = 0; i < lines; ++i) {
+    const auto begin = Clock::now();
+    {
+      std::lock_guard<std::mutex> lock(mu);
+      out << "[worker " << thread_id << "] line " << i << " state=0x" << std::hex
+          << static_cast<std::uint32_t>(i * 2654435761u) << std::dec;
+      if (endl) {
+        out << std::endl;
+      } else {
+        out << '\n';
+      }
+    }
+    latencies.push_back(ElapsedNs(begin, Clock::now()));
+  }
+}
+
+void ProduceAsync(int thread_id, int lines, std::vector<std::uint32_t>& latencies) {
+  for (int i = 0; i < lines; ++i) {
+    const auto begin = Clock::now();
+    async_log::LogLine() << "[worker " << thread_id << "] line " << i << " state="
+                         << async_log::Hex{static_cast<std::uint32_t>(i * 2654435761u)};
+    latencies.push_back(ElapsedNs(begin, Clock::now()));
+  }
+}
+
+bool RunCase(const BenchCase& bench, const BenchConfig& cfg, CaseResult& result) {
+  const int per_thread = cfg.lines / cfg.threads;
+  std::vector<std::vector<std::uint32_t>> latencies(cfg.threads);
+  for (auto& samples : latencies) {
+    samples.reserve(per_thread);
+  }
+
+  std::ofstream out;
+  int fd = -1;
+  const bool async = bench.sink == Sink::kAsyncBlock || bench.sink == Sink::kAsyncDrop;
+  if (async) {
+    fd = ::open(cfg.path.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if (fd < 0) {
+      std::cerr << "open " << cfg.path << ": " << std::strerror(errno) << '\n';
+      return false;
+    }
+    async_log::LoggerOptions options;
+    options.fd = fd;
+    options.overflow = bench.sink == Sink::kAsyncDrop ? async_log::OverflowPolicy::kDrop
+                                                      : async_log::OverflowPolicy::kBlock;
+    std::string error;
+    if (!async_log::Logger::Instance().Start(options, error)) {
+      std::cerr << "async_log: " << error << '\n';
+      ::close(fd);
+      return false;
+    }
+  } else {
+    out.open(cfg.path, std::ios::out | std::ios::trunc);
+    if (!out) {
+      std::cerr << "open " << cfg.path << " failed\n";
+      return false;
+    }
+  }
+
+  const async_log::LoggerStats before = async_log::Logger::Instance().Stats();
+  std::mutex mu;
+  std::vector<std::thread> threads;
+  const auto begin = Clock::now();
+  for (int t = 0; t < cfg.threads; ++t) {
+    threads.emplace_back([&, t] {
+      if (async) {
+        ProduceAsync(t, per_thread, latencies[t]);
+      } else {
+        ProduceIostream(out, mu, bench.sink == Sink::kIostreamEndl, t, per_thread, latencies[t]);
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  if (async) {
+    async_log::Logger::Instance().Flush();
+  } else {
+    out.flush();
+  }
+  result.seconds = std::chrono::duration<double>(Clock::now() - begin).count();
+
+  if (async) {
+    async_log::Logger::Instance().Stop();
+    const async_log::LoggerStats after = async_log::Logger::Instance().Stats();
+    result.stats.lines = after.lines - before.lines;
+    result.stats.dropped = after.dropped - before.dropped;
+    result.stats.writev_calls = after.writev_calls - before.writev_calls;
+    result.stats.sync_lines = after.sync_lines - before.sync_lines;
+    ::close(fd);
+  } else {
+    out.close();
+  }
+  std::ifstream written(cfg.path, std::ios::binary | std::ios::ate);
+  result.file_bytes = static_cast<std::uint64_t>(written.tellg());
+
+  for (const auto& samples : latencies) {
+    result.latencies_ns.insert(result.latencies_ns.end(), samples.begin(), samples.end());
+  }
+  std::sort(result.latencies_ns.begin(), result.latencies_ns.end());
+  return true;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  BenchConfig cfg;
+  if (argc >= 2) {
+    cfg.lines = std::atoi(argv[1]);
+  }
+  if (argc >= 3) {
+    cfg.threads = std::atoi(argv[2]);
+  }
+  if (argc >= 4) {
+    cfg.path = argv[3];
+  }
+  if (cfg.lines <= 0 || cfg.threads <= 0 || cfg.threads > async_log::kMaxThreads / 2) {
+    std::cerr << "usage: " << argv[0] << " [lines] [threads (1.." << async_log::kMaxThreads / 2
+              << ")] [output_file]\n";
+    return 2;
+  }
+
+  std::cout << "== " << cfg.lines << " lines from " << cfg.threads << " thread(s) -> "
+            << cfg.path << " ==\n"
+            << "latency: one logging call as seen by the caller; lines/s: lines actually written "
+               "(dropped lines excluded), until the last one reached the kernel\n\n"
+            << std::left << std::setw(22) << "SINK" << std::right << std::setw(8) << "p50 ns"
+            << std::setw(9) << "p99 ns" << std::setw(10) << "p99.9 ns" << std::setw(10)
+            << "max us" << std::setw(12) << "lines/s" << std::setw(13) << "lines/write"
+            << std::setw(9) << "dropped" << std::setw(11) << "file KiB" << '\n';
+
+  for (const BenchCase& bench : kCases) {
+    CaseResult result;
+    if (!RunCase(bench, cfg, result)) {
+      return 1;
+    }
+    const bool async = bench.sink == Sink::kAsyncBlock || bench.sink == Sink::kAsyncDrop;
+    // 只算真正写出的行：kDrop 丢掉的行不计入吞吐，单独列在 dropped。
+    const std::uint64_t calls = result.latencies_ns.size();
+    const double delivered =
+        async ? static_cast<double>(result.stats.lines + result.stats.sync_lines)
+              : static_cast<double>(calls);
+    std::string per_write = "1";
+    if (bench.sink == Sink::kIostreamBuffered) {
+      per_write = "-";
+    } else if (result.stats.writev_calls > 0) {
+      const double ratio = static_cast<double>(result.stats.lines) /
+                           static_cast<double>(result.stats.writev_calls);
+      per_write = std::to_string(static_cast<long long>(ratio + 0.5));
+    }
+    std::cout << std::left << std::setw(22) << bench.name << std::right << std::setw(8)
+              << Percentile(result.latencies_ns, 50) << std::setw(9)
+              << Percentile(result.latencies_ns, 99) << std::setw(10)
+              << Percentile(result.latencies_ns, 99.9) << std::fixed << std::setprecision(1)
+              << std::setw(10) << result.latencies_ns.back() / 1000.0 << std::setprecision(0)
+              << std::setw(12) << delivered / result.seconds << std::setw(13) << per_write
+              << std::setw(9) << result.stats.dropped << std::setprecision(1) << std::setw(11)
+              << static_cast<double>(result.file_bytes) / 1024 << '\n';
+  }
+  return 0;
+}
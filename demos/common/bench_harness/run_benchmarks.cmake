@@ -0,0 +1,71 @@
+# 依次运行各 demo 的 harness benchmark，把结果合并成一份报告：
+#   <REPORT_DIR>/bench_report.txt   各 benchmark 的表格输出，顺序与 BENCHES 相同
+#   <REPORT_DIR>/bench_report.json  {"generated", "host", "logical_cores", "suites": [每个 benchmark 的 --json 输出]}
+# 用法（通常由顶层 CMakeLists.txt 的 bench_report 目标调用）：
+#   cmake -DDEMOS_BINARY_DIR=<build>/demos -DREPORT_DIR=<build> -DBENCHES=a/x,b/y
+#         [-DBENCH_ARGS="--repetitions 50"] -P run_benchmarks.cmake
+cmake_minimum_required(VERSION 3.16)
+
+foreach(var DEMOS_BINARY_DIR REPORT_DIR BENCHES)
+  if(NOT DEFINED ${var} OR "${${var}}" STREQUAL "")
+    message(FATAL_ERROR "run_benchmarks.cmake: ${var} is required")
+  endif()
+endforeach()
+
+string(REPLACE "," ";" bench_list "${BENCHES}")
+separate_arguments(bench_args UNIX_COMMAND "${BENCH_ARGS}")
+
+set(json_dir "${REPORT_DIR}/bench_json")
+file(MAKE_DIRECTORY "${json_dir}")
+
+string(TIMESTAMP generated "%Y-%m-%dT%H:%M:%SZ" UTC)
+cmake_host_system_information(RESULT host QUERY HOSTNAME)
+cmake_host_system_information(RESULT cores QUERY NUMBER_OF_LOGICAL_CORES)
+
+set(text_report "bench_report ${generated} on ${host} (${cores} logical cores)\n")
+set(suites_json "")
+set(failed "")
+
+foreach(bench ${bench_list})
+  set(exe "${DEMOS_BINARY_DIR}/${bench}")
+  get_filename_component(bench_name "${bench}" NAME)
+  set(json_file "${json_dir}/${bench_name}.json")
+  file(REMOVE "${json_file}")
+
+  message(STATUS "bench_report: ${bench}")
+  if(NOT EXISTS "${exe}")
+    list(APPEND failed "${bench} (not built)")
+    continue()
+  endif()
+  execute_process(
+    COMMAND "${exe}" --json "${json_file}" ${bench_args}
+    OUTPUT_VARIABLE output
+    ERROR_VARIABLE error_output
+    RESULT_VARIABLE result
+  )
+  message("${output}")
+  string(APPEND text_report "\n${output}")
+  if(NOT result EQUAL 0 OR NOT EXISTS "${json_file}")
+    list(APPEND failed "${bench} (exit ${result}: ${error_output})")
+    continue()
+  endif()
+
+  file(READ "${json_file}" suite_json)
+  string(STRIP "${suite_json}" suite_json)
+  if(suites_json STREQUAL "")
+    set(suites_json "${suite_json}")
+  else()
+    string(APPEND suites_json ",\n${suite_json}")
+  endif()
+endforeach()
+
+file(WRITE "${REPORT_DIR}/bench_report.txt" "${text_report}")
+file(WRITE "${REPORT_DIR}/bench_report.json"
+  "{\n\"generated\": \"${generated}\",\n\"host\": \"${host}\",\n\"logical_cores\": ${cores},\n"
+  "\"suites\": [\n${suites_json}\n]\n}\n")
+message(STATUS "bench_report: wrote ${REPORT_DIR}/bench_report.txt and bench_report.json")
+
+if(failed)
+  string(REPLACE ";" "\n  " failed_lines "${failed}")
+  message(FATAL_ERROR "bench_report: some benchmarks failed:\n  ${failed_lines}")
+endif()
@@ -0,0 +1,433 @@
+#include "bench_harness.h"
+
+#include <time.h>
+
+#if defined(__linux__)
+#include <sched.h>
+#endif
+
+#if defined(__x86_64__)
+#include <cpuid.h>
+#include <x86intrin.h>
+#endif
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+
+namespace bench {
+
+namespace {
+
+constexpr int kCalibrationMs = 50;
+constexpr int kOverheadRounds = 10000;
+// 表格里 "suite/name" 列的宽度；更长的名字会顶出一个空格后继续对齐后面的列。
+constexpr int kNameWidth = 60;
+// 批量迭代次数的上限：避免函数体被整个优化掉时无限翻倍。
+constexpr std::uint64_t kMaxBatchIterations = std::uint64_t{1} << 40;
+
+struct Options {
+  std::string json_path;
+  std::string filter;
+  int repetitions = 20;
+  double min_time_ms = 5;
+  double warmup_ms = 50;
+  int samples = 20000;
+  // -2：绑定到启动时所在的 CPU；-1：不绑核。
+  int cpu = -2;
+  bool use_tsc = true;
+  bool list = false;
+};
+
+enum class TimerSource {
+  kTsc,
+  kClock,
+};
+
+struct Timer {
+  TimerSource source = TimerSource::kClock;
+  double ns_per_tick = 1.0;
+  // 连续两次读取之间的最小间隔（ns），延迟型样本会扣掉它。
+  double overhead_ns = 0;
+  double tsc_ghz = 0;
+};
+
+struct Result {
+  std::string name;
+  bool latency = false;
+  std::uint64_t iterations_per_sample = 1;
+  std::size_t samples = 0;
+  Stats ns;
+};
+
+std::uint64_t MonotonicNs() {
+  timespec ts{};
+  ::clock_gettime(CLOCK_MONOTONIC, &ts);
+  return static_cast<std::uint64_t>(ts.tv_sec) * 1000000000ull +
+         static_cast<std::uint64_t>(ts.tv_nsec);
+}
+
+#if defined(__x86_64__)
+bool HasInvariantTsc() {
+  unsigned eax = 0;
+  unsigned ebx = 0;
+  unsigned ecx = 0;
+  unsigned edx = 0;
+  if (__get_cpuid(0x80000000u, &eax, &ebx, &ecx, &edx) == 0 || eax < 0x80000007u) {
+    return false;
+  }
+  __get_cpuid(0x80000007u, &eax, &ebx, &ecx, &edx);
+  return (edx & (1u << 8)) != 0;
+}
+
+// lfence 让 rdtsc 不早于之前的指令执行，也不让之后的指令提前到它前面。
+inline std::uint64_t TscBegin() {
+  _mm_lfence();
+  const std::uint64_t tsc = __rdtsc();
+  _mm_lfence();
+  return tsc;
+}
+
+// rdtscp 等之前的指令全部完成才读；后面的 lfence 挡住之后的指令。
+inline std::uint64_t TscEnd() {
+  unsigned aux = 0;
+  const std::uint64_t tsc = __rdtscp(&aux);
+  _mm_lfence();
+  return tsc;
+}
+#endif
+
+inline std::uint64_t ReadBegin(const Timer& timer) {
+#if defined(__x86_64__)
+  if (timer.source == TimerSource::kTsc) {
+    return TscBegin();
+  }
+#endif
+  (void)timer;
+  return MonotonicNs();
+}
+
+inline std::uint64_t ReadEnd(const Timer& timer) {
+#if defined(__x86_64__)
+  if (timer.source == TimerSource::kTsc) {
+    return TscEnd();
+  }
+#endif
+  (void)timer;
+  return MonotonicNs();
+}
+
+Timer CalibrateTimer(bool use_tsc) {
+  Timer timer;
+#if defined(__x86_64__)
+  if (use_tsc && HasInvariantTsc()) {
+    // 忙等一段墙钟时间，用两端的 (tsc, ns) 求频率。
+    const std::uint64_t ns0 = MonotonicNs();
+    const std::uint64_t tsc0 = TscBegin();
+    while (MonotonicNs() - ns0 < static_cast<std::uint64_t>(kCalibrationMs) * 1000000u) {
+    }
+    const std::uint64_t tsc1 = TscEnd();
+    const std::uint64_t ns1 = MonotonicNs();
+    timer.source = TimerSource::kTsc;
+    timer.ns_per_tick = static_cast<double>(ns1 - ns0) / static_cast<double>(tsc1 - tsc0);
+    timer.tsc_ghz = 1.0 / timer.ns_per_tick;
+  }
+#else
+  (void)use_tsc;
+#endif
+  std::uint64_t best = ~std::uint64_t{0};
+  for (int i = 0; i < kOverheadRounds; ++i) {
+    const std::uint64_t begin = ReadBegin(timer);
+    const std::uint64_t end = ReadEnd(timer);
+    best = std::min(best, end - begin);
+  }
+  timer.overhead_ns = static_cast<double>(best) * timer.ns_per_tick;
+  return timer;
+}
+
+// 返回实际绑定的 CPU；-1 表示没有绑核（未请求或平台不支持）。
+int PinToCpu(int requested) {
+#if defined(__linux__)
+  if (requested == -1) {
+    return -1;
+  }
+  const int cpu = requested == -2 ? ::sched_getcpu() : requested;
+  if (cpu < 0) {
+    return -1;
+  }
+  cpu_set_t set;
+  CPU_ZERO(&set);
+  CPU_SET(cpu, &set);
+  return ::sched_setaffinity(0, sizeof(set), &set) == 0 ? cpu : -1;
+#else
+  (void)requested;
+  return -1;
+#endif
+}
+
+bool ParseOptions(int argc, char** argv, Options& options) {
+  for (int i = 1; i < argc; ++i) {
+    const std::string arg = argv[i];
+    const bool has_value = i + 1 < argc;
+    char* end = nullptr;
+    if (arg == "--json" && has_value) {
+      options.json_path = argv[++i];
+    } else if (arg == "--filter" && has_value) {
+      options.filter = argv[++i];
+    } else if (arg == "--repetitions" && has_value) {
+      options.repetitions = static_cast<int>(std::strtol(argv[++i], &end, 10));
+      if (*end != '\0' || options.repetitions <= 0) {
+        return false;
+      }
+    } else if (arg == "--min-time-ms" && has_value) {
+      options.min_time_ms = std::strtod(argv[++i], &end);
+      if (*end != '\0' || options.min_time_ms <= 0) {
+        return false;
+      }
+    } else if (arg == "--warmup-ms" && has_value) {
+      options.warmup_ms = std::strtod(argv[++i], &end);
+      if (*end != '\0' || options.warmup_ms < 0) {
+        return false;
+      }
+    } else if (arg == "--samples" && has_value) {
+      options.samples = static_cast<int>(std::strtol(argv[++i], &end, 10));
+      if (*end != '\0' || options.samples <= 0) {
+        return false;
+      }
+    } else if (arg == "--cpu" && has_value) {
+      const std::string value = argv[++i];
+      if (value == "none") {
+        options.cpu = -1;
+      } else {
+        options.cpu = static_cast<int>(std::strtol(value.c_str(), &end, 10));
+        if (*end != '\0' || options.cpu < 0) {
+          return false;
+        }
+      }
+    } else if (arg == "--timer" && has_value) {
+      const std::string value = argv[++i];
+      if (value != "tsc" && value != "clock") {
+        return false;
+      }
+      options.use_tsc = value == "tsc";
+    } else if (arg == "--list") {
+      options.list = true;
+    } else {
+      return false;
+    }
+  }
+  return true;
+}
+
+double BatchNs(const Timer& timer, const std::function<void(State&)>& body,
+               std::uint64_t iterations) {
+  State state(iterations);
+  const std::uint64_t begin = ReadBegin(timer);
+  body(state);
+  const std::uint64_t end = ReadEnd(timer);
+  return static_cast<double>(end - begin) * timer.ns_per_tick;
+}
+
+Result RunBatch(const Timer& timer, const Options& options, const std::string& name,
+                const std::function<void(State&)>& body) {
+  Result result;
+  result.name = name;
+  const double min_ns = options.min_time_ms * 1e6;
+  std::uint64_t iterations = 1;
+  while (iterations < kMaxBatchIterations && BatchNs(timer, body, iterations) < min_ns) {
+    iterations *= 2;
+  }
+
+  const std::uint64_t warmup_end =
+      MonotonicNs() + static_cast<std::uint64_t>(options.warmup_ms * 1e6);
+  while (MonotonicNs() < warmup_end) {
+    BatchNs(timer, body, iterations);
+  }
+
+  std::vector<double> samples;
+  samples.reserve(static_cast<std::size_t>(options.repetitions));
+  for (int i = 0; i < options.repetitions; ++i) {
+    samples.push_back(BatchNs(timer, body, iterations) / static_cast<double>(iterations));
+  }
+  result.iterations_per_sample = iterations;
+  result.samples = samples.size();
+  result.ns = ComputeStats(std::move(samples));
+  return result;
+}
+
+Result RunLatency(const Timer& timer, const Options& options, const std::string& name,
+                  const std::function<void()>& body) {
+  Result result;
+  result.name = name;
+  result.latency = true;
+
+  const std::uint64_t warmup_end =
+      MonotonicNs() + static_cast<std::uint64_t>(options.warmup_ms * 1e6);
+  while (MonotonicNs() < warmup_end) {
+    body();
+  }
+
+  std::vector<double> samples;
+  samples.reserve(static_cast<std::size_t>(options.samples));
+  for (int i = 0; i < options.samples; ++i) {
+    const std::uint64_t begin = ReadBegin(timer);
+    body();
+    const std::uint64_t end = ReadEnd(timer);
+    const double ns = static_cast<double>(end - begin) * timer.ns_per_tick - timer.overhead_ns;
+    samples.push_back(std::max(ns, 0.0));
+  }
+  result.samples = samples.size();
+  result.ns = ComputeStats(std::move(samples));
+  return result;
+}
+
+std::string JsonString(const std::string& text) {
+  std::string out = "\"";
+  for (const char c : text) {
+    if (c == '"' || c == '\\') {
+      out += '\\';
+      out += c;
+    } else if (static_cast<unsigned char>(c) < 0x20) {
+      out += ' ';
+    } else {
+      out += c;
+    }
+  }
+  out += '"';
+  return out;
+}
+
+void WriteJson(std::ostream& out, const std::string& suite, const Timer& timer, int cpu,
+               const std::vector<Result>& results) {
+  out << std::setprecision(9) << "{\n  \"suite\": " << JsonString(suite) << ",\n"
+      << "  \"compiler\": " << JsonString(__VERSION__) << ",\n"
+      << "  \"timer\": {\"source\": \""
+      << (timer.source == TimerSource::kTsc ? "rdtsc" : "clock_gettime") << "\", \"tsc_ghz\": "
+      << timer.tsc_ghz << ", \"overhead_ns\": " << timer.overhead_ns << "},\n"
+      << "  \"cpu\": " << cpu << ",\n  \"benchmarks\": [";
+  for (std::size_t i = 0; i < results.size(); ++i) {
+    const Result& r = results[i];
+    out << (i == 0 ? "\n" : ",\n") << "    {\"name\": " << JsonString(r.name)
+        << ", \"kind\": \"" << (r.latency ? "latency" : "throughput") << "\""
+        << ", \"iterations_per_sample\": " << r.iterations_per_sample
+        << ", \"samples\": " << r.samples << ", \"ns_per_op\": {\"mean\": " << r.ns.mean
+        << ", \"stddev\": " << r.ns.stddev << ", \"min\": " << r.ns.min
+        << ", \"p50\": " << r.ns.p50 << ", \"p90\": " << r.ns.p90 << ", \"p99\": " << r.ns.p99
+        << ", \"max\": " << r.ns.max << "}}";
+  }
+  out << "\n  ]\n}\n";
+}
+
+void PrintRow(const std::string& suite, const Result& r) {
+  std::cout << std::left << std::setw(kNameWidth) << (suite + "/" + r.name) << ' '
+            << std::setw(5) << (r.latency ? "lat" : "tput") << std::right << std::fixed
+            << std::setprecision(1) << std::setw(10) << r.ns.p50 << std::setw(10) << r.ns.p90
+            << std::setw(10) << r.ns.p99 << std::setw(10) << r.ns.min << std::setw(11) << r.ns.max
+            << std::setw(7) << (r.ns.mean > 0 ? r.ns.stddev / r.ns.mean * 100.0 : 0.0) << "%\n";
+}
+
+}  // namespace
+
+Stats ComputeStats(std::vector<double> samples) {
+  Stats stats;
+  if (samples.empty()) {
+    return stats;
+  }
+  std::sort(samples.begin(), samples.end());
+  double sum = 0;
+  for (const double value : samples) {
+    sum += value;
+  }
+  stats.mean = sum / static_cast<double>(samples.size());
+  double variance = 0;
+  for (const double value : samples) {
+    variance += (value - stats.mean) * (value - stats.mean);
+  }
+  stats.stddev = std::sqrt(variance / static_cast<double>(samples.size()));
+  const auto rank = [&samples](double q) {
+    const auto index = static_cast<std::size_t>(std::ceil(q * static_cast<double>(samples.size())));
+    return samples[std::min(samples.size() - 1, index == 0 ? 0 : index - 1)];
+  };
+  stats.min = samples.front();
+  stats.p50 = rank(0.50);
+  stats.p90 = rank(0.90);
+  stats.p99 = rank(0.99);
+  stats.max = samples.back();
+  return stats;
+}
+
+Suite& Suite::Add(std::string name, std::function<void(State&)> body) {
+  Entry entry;
+  entry.name = std::move(name);
+  entry.batch = std::move(body);
+  entries_.push_back(std::move(entry));
+  return *this;
+}
+
+Suite& Suite::AddLatency(std::string name, std::function<void()> body) {
+  Entry entry;
+  entry.name = std::move(name);
+  entry.latency = true;
+  entry.single = std::move(body);
+  entries_.push_back(std::move(entry));
+  return *this;
+}
+
+int Suite::Run(int argc, char** argv) {
+  Options options;
+  if (!ParseOptions(argc, argv, options)) {
+    std::cerr << "usage: " << argv[0]
+              << " [--filter SUBSTR] [--repetitions N] [--min-time-ms MS] [--warmup-ms MS]"
+                 " [--samples N] [--cpu N|none] [--timer tsc|clock] [--json PATH] [--list]\n";
+    return 2;
+  }
+  if (options.list) {
+    for (const Entry& entry : entries_) {
+      std::cout << name_ << '/' << entry.name << '\n';
+    }
+    return 0;
+  }
+
+  const int cpu = PinToCpu(options.cpu);
+  const Timer timer = CalibrateTimer(options.use_tsc);
+  std::cout << "== " << name_ << ": "
+            << (timer.source == TimerSource::kTsc ? "rdtsc" : "clock_gettime") << std::fixed
+            << std::setprecision(3);
+  if (timer.source == TimerSource::kTsc) {
+    std::cout << " @ " << timer.tsc_ghz << " GHz";
+  }
+  std::cout << std::setprecision(1) << ", timer overhead " << timer.overhead_ns << " ns, "
+            << (cpu >= 0 ? "pinned to cpu " + std::to_string(cpu) : std::string("not pinned"))
+            << " ==\n"
+            << std::left << std::setw(kNameWidth) << "BENCHMARK" << ' ' << std::setw(5) << "KIND"
+            << std::right << std::setw(10) << "p50 ns" << std::setw(10) << "p90 ns"
+            << std::setw(10) << "p99 ns" << std::setw(10) << "min ns" << std::setw(11)
+            << "max ns" << std::setw(8) << "cv" << '\n';
+
+  std::vector<Result> results;
+  for (const Entry& entry : entries_) {
+    if (!options.filter.empty() && entry.name.find(options.filter) == std::string::npos) {
+      continue;
+    }
+    results.push_back(entry.latency ? RunLatency(timer, options, entry.name, entry.single)
+                                    : RunBatch(timer, options, entry.name, entry.batch));
+    PrintRow(name_, results.back());
+  }
+
+  if (!options.json_path.empty()) {
+    std::ofstream out(options.json_path, std::ios::trunc);
+    WriteJson(out, name_, timer, cpu, results);
+    if (!out) {
+      std::cerr << "failed to write " << options.json_path << '\n';
+      return 1;
+    }
+  }
+  return 0;
+}
+
+}  // namespace bench
@@ -0,0 +1,91 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace bench {
+
+/*
+ * 让编译器认为 value 被读取（且可能被修改），计算它的代码不能当成死代码删掉；
+ * 不引入额外的内存访问。与 ClobberMemory() 配合可阻止循环被外提或合并。
+ */
+template <typename T>
+inline void DoNotOptimize(const T& value) {
+  asm volatile("" : : "r,m"(value) : "memory");
+}
+
+template <typename T>
+inline void DoNotOptimize(T& value) {
+#if defined(__clang__)
+  asm volatile("" : "+r,m"(value) : : "memory");
+#else
+  asm volatile("" : "+m,r"(value) : : "memory");
+#endif
+}
+
+// 编译器屏障：之前的写入必须真正落到内存，之后的读取必须重新从内存读。
+inline void ClobberMemory() {
+  asm volatile("" : : : "memory");
+}
+
+// 吞吐型 benchmark 的上下文：函数体自己循环 iterations() 次，harness 只计整批的时间。
+class State final {
+ public:
+  explicit State(std::uint64_t iterations) : iterations_(iterations) {}
+
+  std::uint64_t iterations() const { return iterations_; }
+
+ private:
+  std::uint64_t iterations_;
+};
+
+struct Stats {
+  double mean = 0;
+  double stddev = 0;
+  double min = 0;
+  double p50 = 0;
+  double p90 = 0;
+  double p99 = 0;
+  double max = 0;
+};
+
+// 把样本排序后按最近秩取分位数；样本为空时全部为 0。
+Stats ComputeStats(std::vector<double> samples);
+
+/*
+ * 一组 benchmark（通常是一个 demo 的全部热路径）：
+ * - Add()：吞吐型。先把每批的迭代次数翻倍到单批耗时不少于 --min-time-ms，
+ *   预热 --warmup-ms 后跑 --repetitions 批，每批得到一个 ns/op 样本。
+ *   适合几纳秒到几百纳秒的操作，分位数是“批平均值”的分布。
+ * - AddLatency()：延迟型。每次调用单独计时（扣除计时本身的开销），
+ *   预热后采 --samples 次，分位数是单次调用的分布。适合 100ns 以上、需要看尾延迟的操作。
+ * - Run() 解析命令行、校准计时器、按需绑核，打印统一格式的表格，并可写 JSON（--json）。
+ *
+ * 计时源：x86_64 上 CPU 声明了 invariant TSC 时用 rdtsc（启动时对 CLOCK_MONOTONIC 校准频率），
+ * 否则或指定 --timer clock 时用 clock_gettime(CLOCK_MONOTONIC)。
+ */
+class Suite final {
+ public:
+  explicit Suite(std::string name) : name_(std::move(name)) {}
+
+  Suite& Add(std::string name, std::function<void(State&)> body);
+  Suite& AddLatency(std::string name, std::function<void()> body);
+
+  // 返回进程退出码：0 成功，2 参数错误。
+  int Run(int argc, char** argv);
+
+ private:
+  struct Entry {
+    std::string name;
+    bool latency = false;
+    std::function<void(State&)> batch;
+    std::function<void()> single;
+  };
+
+  std::string name_;
+  std::vector<Entry> entries_;
+};
+
+}  // namespace bench
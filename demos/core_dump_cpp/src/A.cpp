@@ -1,11 +1,11 @@
 #include "A.h"
 
-#include <iostream>
+#include "async_log.h"
 
 A::A() {
-  std::cout << "[A] ctor" << std::endl;
+  async_log::LogLine() << "[A] ctor";
 }
 
 A::~A() {
-  std::cout << "[A] dtor" << std::endl;
+  async_log::LogLine() << "[A] dtor";
 }
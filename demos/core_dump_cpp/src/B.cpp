@@ -1,16 +1,17 @@
 #include "B.h"
 
-#include <iostream>
+#include "async_log.h"
 
 B::B() : ptr_(nullptr) {
-  std::cout << "[B] ctor, ptr_ = nullptr" << std::endl;
+  async_log::LogLine() << "[B] ctor, ptr_ = nullptr";
 }
 
 B::~B() {
-  std::cout << "[B] dtor: demo starts" << std::endl;
-  std::cout << "[B] try release nullptr (delete nullptr is safe in C++)" << std::endl;
+  // 这几行在崩溃时多半还在日志环里，由 async_log 的崩溃 handler 写出。
+  async_log::LogLine() << "[B] dtor: demo starts";
+  async_log::LogLine() << "[B] try release nullptr (delete nullptr is safe in C++)";
   delete ptr_;
 
-  std::cout << "[B] force crash for core dump by writing nullptr" << std::endl;
+  async_log::LogLine() << "[B] force crash for core dump by writing nullptr";
   *ptr_ = 42;  // NOLINT intentionally crash for demo.
 }
@@ -0,0 +1,533 @@
+#include "module_symbolizer.h"
+
+#include <elf.h>
+#include <fcntl.h>
+#include <signal.h>
+#include <sys/mman.h>
+#include <sys/procfs.h>
+#include <sys/stat.h>
+#include <sys/user.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+namespace fs = std::filesystem;
+using Clock = std::chrono::steady_clock;
+
+constexpr int kMaxFrames = 64;
+constexpr int kDefaultSignatureFrames = 6;
+// 帧指针回溯少于这个深度时，退回扫描栈上指向函数内部的值。
+constexpr int kScanBelowDepth = 3;
+constexpr int kMaxScannedFrames = 12;
+constexpr std::uint64_t kScanBytes = 8u << 10;
+constexpr std::uint64_t kMaxStackSpan = 8u << 20;
+// core(5)：NT_FILE / NT_SIGINFO 的 note 类型值（旧版 elf.h 可能没有定义）。
+constexpr std::uint32_t kNoteFile = 0x46494c45;
+constexpr std::uint32_t kNoteSiginfo = 0x53494749;
+
+struct CoreThread {
+  int tid = 0;
+  int signo = 0;
+  std::uint64_t pc = 0;
+  std::uint64_t sp = 0;
+  std::uint64_t fp = 0;
+};
+
+/*
+ * 只读 mmap 一个 ELF core：解析程序头、PT_NOTE 里的 NT_PRSTATUS / NT_FILE / NT_SIGINFO，
+ * 再按需读取 PT_LOAD 里的栈内存。文件其余部分（堆等）不会被访问，也就不会从磁盘读入。
+ */
+class CoreFile final {
+ public:
+  CoreFile() = default;
+  CoreFile(const CoreFile&) = delete;
+  CoreFile& operator=(const CoreFile&) = delete;
+
+  ~CoreFile() {
+    if (data_ != nullptr) {
+      ::munmap(const_cast<unsigned char*>(data_), size_);
+    }
+  }
+
+  bool Open(const std::string& path, std::string& error) {
+    const int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+      error = std::strerror(errno);
+      return false;
+    }
+    struct stat st {};
+    if (::fstat(fd, &st) != 0 || static_cast<std::size_t>(st.st_size) < sizeof(Elf64_Ehdr)) {
+      ::close(fd);
+      error = "not an ELF core";
+      return false;
+    }
+    size_ = static_cast<std::size_t>(st.st_size);
+    void* mapped = ::mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if (mapped == MAP_FAILED) {
+      error = std::string("mmap: ") + std::strerror(errno);
+      return false;
+    }
+    data_ = static_cast<const unsigned char*>(mapped);
+    // 只会零散地读几页，关掉预读，避免把大块堆数据顺带读进页缓存。
+    ::madvise(mapped, size_, MADV_RANDOM);
+
+    Elf64_Ehdr ehdr{};
+    std::memcpy(&ehdr, data_, sizeof(ehdr));
+    if (std::memcmp(ehdr.e_ident, ELFMAG, SELFMAG) != 0 || ehdr.e_ident[EI_CLASS] != ELFCLASS64 ||
+        ehdr.e_type != ET_CORE ||
+        !InFile(ehdr.e_phoff, std::uint64_t{ehdr.e_phnum} * sizeof(Elf64_Phdr))) {
+      error = "not a 64-bit ELF core";
+      return false;
+    }
+    touched_ += sizeof(ehdr) + std::uint64_t{ehdr.e_phnum} * sizeof(Elf64_Phdr);
+    for (int i = 0; i < ehdr.e_phnum; ++i) {
+      Elf64_Phdr phdr{};
+      std::memcpy(&phdr, data_ + ehdr.e_phoff + i * sizeof(Elf64_Phdr), sizeof(phdr));
+      if (phdr.p_type == PT_LOAD) {
+        loads_.push_back(phdr);
+      } else if (phdr.p_type == PT_NOTE && InFile(phdr.p_offset, phdr.p_filesz)) {
+        ParseNotes(data_ + phdr.p_offset, phdr.p_filesz);
+        touched_ += phdr.p_filesz;
+      }
+    }
+    if (threads_.empty()) {
+      error = "no NT_PRSTATUS note";
+      return false;
+    }
+    ReadBuildIds();
+    return true;
+  }
+
+  // 返回指向 core 内容的指针；地址不在 core 里（未映射或被过滤掉）时返回 nullptr。
+  const unsigned char* Read(std::uint64_t address, std::uint64_t bytes) {
+    for (const Elf64_Phdr& load : loads_) {
+      if (address >= load.p_vaddr && address - load.p_vaddr < load.p_filesz &&
+          bytes <= load.p_filesz - (address - load.p_vaddr) &&
+          InFile(load.p_offset + (address - load.p_vaddr), bytes)) {
+        touched_ += bytes;
+        return data_ + load.p_offset + (address - load.p_vaddr);
+      }
+    }
+    return nullptr;
+  }
+
+  bool ReadWord(std::uint64_t address, std::uint64_t& value) {
+    const unsigned char* p = Read(address, sizeof(value));
+    if (p == nullptr) {
+      return false;
+    }
+    std::memcpy(&value, p, sizeof(value));
+    return true;
+  }
+
+  // 第一个 NT_PRSTATUS 是触发 core 的线程。
+  const std::vector<CoreThread>& threads() const { return threads_; }
+  const std::vector<ModuleMapping>& mappings() const { return mappings_; }
+  std::uint64_t fault_address() const { return fault_address_; }
+  std::size_t size() const { return size_; }
+  std::uint64_t touched() const { return touched_; }
+
+ private:
+  bool InFile(std::uint64_t offset, std::uint64_t bytes) const {
+    return offset <= size_ && bytes <= size_ - offset;
+  }
+
+  void ParseNotes(const unsigned char* notes, std::uint64_t size) {
+    std::uint64_t pos = 0;
+    while (pos + sizeof(Elf64_Nhdr) <= size) {
+      Elf64_Nhdr nhdr{};
+      std::memcpy(&nhdr, notes + pos, sizeof(nhdr));
+      const std::uint64_t name_at = pos + sizeof(nhdr);
+      const std::uint64_t desc_at = name_at + ((nhdr.n_namesz + 3u) & ~3u);
+      pos = desc_at + ((nhdr.n_descsz + 3u) & ~3u);
+      if (pos > size) {
+        break;
+      }
+      const unsigned char* desc = notes + desc_at;
+      if (nhdr.n_type == NT_PRSTATUS && nhdr.n_descsz >= sizeof(prstatus_t)) {
+        ParsePrstatus(desc);
+      } else if (nhdr.n_type == kNoteFile) {
+        ParseFileNote(desc, nhdr.n_descsz);
+      } else if (nhdr.n_type == kNoteSiginfo && nhdr.n_descsz >= sizeof(siginfo_t)) {
+        siginfo_t info{};
+        std::memcpy(&info, desc, sizeof(info));
+        // kill/raise 发出的信号（si_code <= 0）里 si_addr 位置放的是发送者 pid，不是地址。
+        fault_address_ = info.si_code > 0 ? reinterpret_cast<std::uint64_t>(info.si_addr) : 0;
+      }
+    }
+  }
+
+  void ParsePrstatus(const unsigned char* desc) {
+    prstatus_t status{};
+    std::memcpy(&status, desc, sizeof(status));
+    CoreThread thread;
+    thread.tid = status.pr_pid;
+    thread.signo = status.pr_cursig;
+#if defined(__x86_64__)
+    user_regs_struct regs{};
+    static_assert(sizeof(regs) == sizeof(status.pr_reg), "unexpected prstatus layout");
+    std::memcpy(&regs, &status.pr_reg, sizeof(regs));
+    thread.pc = regs.rip;
+    thread.sp = regs.rsp;
+    thread.fp = regs.rbp;
+#elif defined(__aarch64__)
+    user_regs_struct regs{};
+    std::memcpy(&regs, &status.pr_reg, sizeof(regs));
+    thread.pc = regs.pc;
+    thread.sp = regs.sp;
+    thread.fp = regs.regs[29];
+#endif
+    threads_.push_back(thread);
+  }
+
+  // NT_FILE：count、page_size，然后 count 组 {start, end, 文件页号}，最后是以 NUL 分隔的路径。
+  void ParseFileNote(const unsigned char* desc, std::uint64_t size) {
+    std::uint64_t header[2] = {};
+    if (size < sizeof(header)) {
+      return;
+    }
+    std::memcpy(header, desc, sizeof(header));
+    const std::uint64_t count = header[0];
+    const std::uint64_t page_size = header[1];
+    const std::uint64_t table_bytes = count * 3 * sizeof(std::uint64_t);
+    if (count > size / (3 * sizeof(std::uint64_t)) || sizeof(header) + table_bytes > size) {
+      return;
+    }
+    const char* names = reinterpret_cast<const char*>(desc + sizeof(header) + table_bytes);
+    const char* names_end = reinterpret_cast<const char*>(desc + size);
+    for (std::uint64_t i = 0; i < count && names < names_end; ++i) {
+      std::uint64_t entry[3] = {};
+      std::memcpy(entry, desc + sizeof(header) + i * sizeof(entry), sizeof(entry));
+      ModuleMapping mapping;
+      mapping.start = entry[0];
+      mapping.end = entry[1];
+      mapping.offset = entry[2] * page_size;
+      mapping.path.assign(names, strnlen(names, static_cast<std::size_t>(names_end - names)));
+      names += mapping.path.size() + 1;
+      mappings_.push_back(std::move(mapping));
+    }
+    std::sort(mappings_.begin(), mappings_.end(),
+              [](const ModuleMapping& a, const ModuleMapping& b) { return a.start < b.start; });
+  }
+
+  // 默认 coredump_filter 的 bit 4 会把每个 ELF 文件映射的首页写进 core：从这一页的程序头
+  // 找到 PT_NOTE，读出崩溃时模块的 build-id，记到该路径的所有映射上。
+  void ReadBuildIds() {
+    for (const ModuleMapping& mapping : mappings_) {
+      if (mapping.offset != 0 || !mapping.build_id.empty()) {
+        continue;
+      }
+      const std::string id = ReadBuildId(mapping);
+      if (id.empty()) {
+        continue;
+      }
+      for (ModuleMapping& other : mappings_) {
+        if (other.path == mapping.path) {
+          other.build_id = id;
+        }
+      }
+    }
+  }
+
+  std::string ReadBuildId(const ModuleMapping& mapping) {
+    const std::uint64_t span = mapping.end - mapping.start;
+    Elf64_Ehdr ehdr{};
+    const unsigned char* p = Read(mapping.start, sizeof(ehdr));
+    if (p == nullptr) {
+      return std::string();
+    }
+    std::memcpy(&ehdr, p, sizeof(ehdr));
+    const std::uint64_t phdrs_bytes = std::uint64_t{ehdr.e_phnum} * sizeof(Elf64_Phdr);
+    if (std::memcmp(ehdr.e_ident, ELFMAG, SELFMAG) != 0 || ehdr.e_ident[EI_CLASS] != ELFCLASS64 ||
+        ehdr.e_phoff > span || phdrs_bytes > span - ehdr.e_phoff) {
+      return std::string();
+    }
+    for (int i = 0; i < ehdr.e_phnum; ++i) {
+      Elf64_Phdr phdr{};
+      p = Read(mapping.start + ehdr.e_phoff + i * sizeof(Elf64_Phdr), sizeof(phdr));
+      if (p == nullptr) {
+        return std::string();
+      }
+      std::memcpy(&phdr, p, sizeof(phdr));
+      // 映射从文件偏移 0 开始，note 在这一映射内时地址就是 start + p_offset。
+      if (phdr.p_type != PT_NOTE || phdr.p_offset > span || phdr.p_filesz > span - phdr.p_offset) {
+        continue;
+      }
+      const unsigned char* notes = Read(mapping.start + phdr.p_offset, phdr.p_filesz);
+      const std::string id = notes != nullptr ? FindGnuBuildId(notes, phdr.p_filesz) : "";
+      if (!id.empty()) {
+        return id;
+      }
+    }
+    return std::string();
+  }
+
+  const unsigned char* data_ = nullptr;
+  std::size_t size_ = 0;
+  std::uint64_t touched_ = 0;
+  std::vector<Elf64_Phdr> loads_;
+  std::vector<CoreThread> threads_;
+  std::vector<ModuleMapping> mappings_;
+  std::uint64_t fault_address_ = 0;
+};
+
+struct CoreResult {
+  std::string path;
+  std::string error;
+  int signo = 0;
+  int threads = 0;
+  std::uint64_t fault_address = 0;
+  std::string executable;
+  // 崩溃线程从栈顶开始的函数名（与加载地址无关），以及是否来自栈扫描。
+  std::vector<std::string> frames;
+  // 对应帧所在模块的 build-id 与磁盘上的文件对不上（或缺失），只给出“模块+文件偏移”。
+  std::vector<bool> unverified;
+  bool scanned = false;
+  std::uint64_t signature = 0;
+  std::uint64_t mapped_bytes = 0;
+  std::uint64_t touched_bytes = 0;
+};
+
+std::uint64_t Fnv1a(const std::string& text, std::uint64_t hash = 1469598103934665603ull) {
+  for (const unsigned char c : text) {
+    hash ^= c;
+    hash *= 1099511628211ull;
+  }
+  return hash;
+}
+
+std::vector<std::uint64_t> UnwindFramePointers(CoreFile& core, const CoreThread& thread) {
+  std::vector<std::uint64_t> pcs{thread.pc};
+  std::uint64_t fp = thread.fp;
+  // 帧布局：[fp] = 上一帧 fp，[fp + 8] = 返回地址。要求 fp 单调递增且不越出栈范围。
+  while (static_cast<int>(pcs.size()) < kMaxFrames) {
+    if (fp < thread.sp || fp - thread.sp >= kMaxStackSpan || fp % 8 != 0) {
+      break;
+    }
+    std::uint64_t next_fp = 0;
+    std::uint64_t return_addr = 0;
+    if (!core.ReadWord(fp, next_fp) || !core.ReadWord(fp + 8, return_addr) || return_addr == 0) {
+      break;
+    }
+    // 返回地址减 1 落回 call 指令内部，符号化时才会归到调用者。
+    pcs.push_back(return_addr - 1);
+    if (next_fp <= fp) {
+      break;
+    }
+    fp = next_fp;
+  }
+  return pcs;
+}
+
+// 栈扫描：可能混入失效的旧返回地址，只在帧指针回溯失败（如崩在不保留帧指针的 libc 里）时使用。
+std::vector<std::uint64_t> ScanStack(CoreFile& core, const CoreThread& thread,
+                                     ModuleSymbolizer& symbolizer) {
+  std::vector<std::uint64_t> pcs{thread.pc};
+  for (std::uint64_t offset = 0;
+       offset < kScanBytes && static_cast<int>(pcs.size()) <= kMaxScannedFrames; offset += 8) {
+    std::uint64_t word = 0;
+    if (!core.ReadWord(thread.sp + offset, word)) {
+      break;
+    }
+    if (word != 0 && symbolizer.IsFunctionAddress(word - 1)) {
+      pcs.push_back(word - 1);
+    }
+  }
+  return pcs;
+}
+
+CoreResult TriageCore(const std::string& path, ModuleSymbolizer& symbolizer,
+                      int signature_frames) {
+  CoreResult result;
+  result.path = path;
+  CoreFile core;
+  if (!core.Open(path, result.error)) {
+    return result;
+  }
+  result.mapped_bytes = core.size();
+  const CoreThread& crashed = core.threads().front();
+  result.signo = crashed.signo;
+  result.threads = static_cast<int>(core.threads().size());
+  result.fault_address = core.fault_address();
+  if (!core.mappings().empty()) {
+    const std::string& exe = core.mappings().front().path;
+    result.executable = exe.substr(exe.rfind('/') + 1);
+  }
+
+  symbolizer.Reset(core.mappings());
+  std::vector<std::uint64_t> pcs = UnwindFramePointers(core, crashed);
+  if (static_cast<int>(pcs.size()) < kScanBelowDepth) {
+    pcs = ScanStack(core, crashed, symbolizer);
+    result.scanned = true;
+  }
+
+  std::uint64_t hash = Fnv1a(std::to_string(result.signo));
+  for (std::size_t i = 0; i < pcs.size(); ++i) {
+    bool verified = true;
+    result.frames.push_back(symbolizer.StableName(pcs[i], &verified));
+    result.unverified.push_back(!verified);
+    if (static_cast<int>(i) < signature_frames) {
+      hash = Fnv1a(result.frames.back() + '\n', hash);
+    }
+  }
+  result.signature = hash;
+  result.touched_bytes = core.touched();
+  return result;
+}
+
+std::vector<std::string> CollectCores(const std::vector<std::string>& inputs) {
+  std::vector<std::string> files;
+  for (const std::string& input : inputs) {
+    std::error_code ec;
+    if (fs::is_directory(input, ec)) {
+      for (const auto& entry : fs::directory_iterator(input, ec)) {
+        if (entry.is_regular_file(ec)) {
+          files.push_back(entry.path().string());
+        }
+      }
+    } else {
+      files.push_back(input);
+    }
+  }
+  std::sort(files.begin(), files.end());
+  return files;
+}
+
+const char* SignalName(int signo) {
+  switch (signo) {
+    case SIGABRT:
+      return "SIGABRT";
+    case SIGBUS:
+      return "SIGBUS";
+    case SIGFPE:
+      return "SIGFPE";
+    case SIGILL:
+      return "SIGILL";
+    case SIGSEGV:
+      return "SIGSEGV";
+    default:
+      return "?";
+  }
+}
+
+struct Group {
+  std::uint64_t signature = 0;
+  int count = 0;
+  const CoreResult* example = nullptr;
+};
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  int jobs = static_cast<int>(std::max(1u, std::thread::hardware_concurrency()));
+  int signature_frames = kDefaultSignatureFrames;
+  std::vector<std::string> inputs;
+  bool ok = true;
+  for (int i = 1; i < argc && ok; ++i) {
+    const std::string arg = argv[i];
+    if (arg == "-j" && i + 1 < argc) {
+      jobs = std::atoi(argv[++i]);
+      ok = jobs > 0 && jobs <= 256;
+    } else if (arg == "--frames" && i + 1 < argc) {
+      signature_frames = std::atoi(argv[++i]);
+      ok = signature_frames > 0 && signature_frames <= kMaxFrames;
+    } else if (arg.compare(0, 1, "-") == 0) {
+      ok = false;
+    } else {
+      inputs.push_back(arg);
+    }
+  }
+  if (!ok || inputs.empty()) {
+    std::cerr << "usage: " << argv[0] << " [-j workers] [--frames N] <core_dir | core>...\n";
+    return 2;
+  }
+
+  const std::vector<std::string> files = CollectCores(inputs);
+  std::vector<CoreResult> results(files.size());
+  std::atomic<std::size_t> next{0};
+  const auto begin = Clock::now();
+  std::vector<std::thread> workers;
+  for (int w = 0; w < jobs; ++w) {
+    workers.emplace_back([&]() {
+      // 每个线程一份符号表缓存：同一批 core 多半来自同一个二进制，只在第一次读取其 ELF。
+      ModuleSymbolizer symbolizer;
+      symbolizer.set_verify_build_id(true);
+      for (std::size_t i = next.fetch_add(1); i < files.size(); i = next.fetch_add(1)) {
+        results[i] = TriageCore(files[i], symbolizer, signature_frames);
+      }
+    });
+  }
+  for (auto& worker : workers) {
+    worker.join();
+  }
+  const double elapsed_ms =
+      std::chrono::duration<double, std::milli>(Clock::now() - begin).count();
+
+  std::map<std::uint64_t, Group> groups;
+  std::size_t parsed = 0;
+  std::uint64_t mapped = 0;
+  std::uint64_t touched = 0;
+  for (const CoreResult& result : results) {
+    if (!result.error.empty()) {
+      continue;
+    }
+    ++parsed;
+    mapped += result.mapped_bytes;
+    touched += result.touched_bytes;
+    Group& group = groups[result.signature];
+    group.signature = result.signature;
+    if (group.count++ == 0) {
+      group.example = &result;
+    }
+  }
+
+  std::cout << "== core triage: " << files.size() << " files, " << jobs << " workers ==\n"
+            << std::fixed << std::setprecision(1) << "parsed " << parsed << " cores in "
+            << elapsed_ms << " ms (" << parsed * 1000.0 / elapsed_ms << " cores/s), mapped "
+            << static_cast<double>(mapped) / (1u << 20) << " MiB, touched " << static_cast<double>(touched) / 1024 << " KiB\n";
+  for (const CoreResult& result : results) {
+    if (!result.error.empty()) {
+      std::cout << "skipped " << result.path << ": " << result.error << '\n';
+    }
+  }
+
+  std::vector<const Group*> sorted;
+  for (const auto& entry : groups) {
+    sorted.push_back(&entry.second);
+  }
+  std::sort(sorted.begin(), sorted.end(), [](const Group* a, const Group* b) {
+    return a->count != b->count ? a->count > b->count : a->signature < b->signature;
+  });
+  for (const Group* group : sorted) {
+    const CoreResult& example = *group->example;
+    std::cout << "\nsignature " << std::hex << std::setw(16) << std::setfill('0')
+              << group->signature << std::setfill(' ') << std::dec << "  " << group->count
+              << " core(s)  " << SignalName(example.signo) << " at 0x" << std::hex
+              << example.fault_address << std::dec << "  " << example.executable << ", "
+              << example.threads << " thread(s)" << (example.scanned ? ", stack scanned" : "")
+              << "\n  example: " << example.path << '\n';
+    for (std::size_t i = 0; i < example.frames.size(); ++i) {
+      std::cout << "  #" << std::left << std::setw(3) << i << std::right << example.frames[i]
+                << (example.unverified[i] ? "  (build-id unverified)" : "")
+                << (static_cast<int>(i) < signature_frames ? "" : "  (not in signature)")
+                << '\n';
+    }
+  }
+  return parsed == 0 ? 1 : 0;
+}
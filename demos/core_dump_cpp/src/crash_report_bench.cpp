@@ -0,0 +1,312 @@
+#include "A.h"
+#include "B.h"
+#include "async_log.h"
+#include "crash_reporter.h"
+#include "dump_arena.h"
+
+#include <elf.h>
+#include <fcntl.h>
+#include <sys/resource.h>
+#include <sys/stat.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+namespace fs = std::filesystem;
+using Clock = std::chrono::steady_clock;
+
+constexpr int kParkedWorkers = 2;
+constexpr const char* kMinidumpName = "minidump.mdmp";
+
+// 不写入 core 的映射类型位：去掉 bit 0（匿名私有），堆和线程栈一起被排除。
+constexpr int kNoAnonPrivateFilter = 0x32;
+
+enum class DumpMode {
+  kNone,
+  kKernelCore,
+  kMinidump,
+  kMinidumpAndCore,
+};
+
+enum class HeapPlacement {
+  kMalloc,
+  kDontDumpArena,
+};
+
+struct BenchCase {
+  const char* name;
+  DumpMode mode;
+  HeapPlacement heap;
+  // 子进程启动时写入 /proc/self/coredump_filter；-1 表示不修改。
+  int coredump_filter;
+};
+
+constexpr BenchCase kCases[] = {
+    {"no dump (ulimit -c 0)", DumpMode::kNone, HeapPlacement::kMalloc, -1},
+    {"kernel core", DumpMode::kKernelCore, HeapPlacement::kMalloc, -1},
+    {"core, heap in DONTDUMP", DumpMode::kKernelCore, HeapPlacement::kDontDumpArena, -1},
+    {"core, filter 0x32", DumpMode::kKernelCore, HeapPlacement::kMalloc, kNoAnonPrivateFilter},
+    {"minidump", DumpMode::kMinidump, HeapPlacement::kMalloc, -1},
+    {"minidump + kernel core", DumpMode::kMinidumpAndCore, HeapPlacement::kMalloc, -1},
+};
+
+// 子进程在崩溃前通过管道报告的内容。
+struct ReadyMessage {
+  std::int64_t timestamp = 0;
+  std::uint64_t heap_address = 0;
+  std::uint64_t stack_address = 0;
+};
+
+enum class Presence {
+  kNoCore,
+  kPresent,
+  kMissing,
+};
+
+struct RoundResult {
+  double exit_ms = 0;
+  std::uint64_t core_bytes = 0;
+  std::uint64_t minidump_bytes = 0;
+  bool signaled = false;
+  bool core_flag = false;
+  Presence heap = Presence::kNoCore;
+  Presence stack = Presence::kNoCore;
+};
+
+void ParkForever() {
+  static std::mutex mu;
+  static std::condition_variable cv;
+  std::unique_lock<std::mutex> lock(mu);
+  cv.wait(lock, [] { return false; });
+}
+
+// 子进程：准备好堆与线程后，把“即将崩溃”的时间戳写进管道，再走 B::~B() 的崩溃路径。
+[[noreturn]] void RunChild(const BenchCase& bench, std::size_t heap_bytes, const fs::path& workdir,
+                           int ready_fd) {
+  const DumpMode mode = bench.mode;
+  if (::chdir(workdir.c_str()) != 0) {
+    ::_exit(10);
+  }
+  const int devnull = ::open("/dev/null", O_WRONLY);
+  ::dup2(devnull, STDOUT_FILENO);
+  ::dup2(devnull, STDERR_FILENO);
+
+  rlimit limit{};
+  ::getrlimit(RLIMIT_CORE, &limit);
+  limit.rlim_cur = mode == DumpMode::kNone ? 0 : limit.rlim_max;
+  ::setrlimit(RLIMIT_CORE, &limit);
+
+  // 与 main.cpp 相同的顺序：先启动日志写线程，crash reporter 之后再装崩溃 flush，
+  // 测到的是 demo 实际运行时的配置（多一个写线程，崩溃时先写出日志）。
+  std::string error;
+  async_log::LoggerOptions log_options;
+  log_options.deliverable_signals = {SIGSEGV, SIGBUS, SIGABRT, SIGFPE, SIGILL,
+                                     crash_report::CrashReporter::CaptureSignal()};
+  if (!async_log::Logger::Instance().Start(log_options, error)) {
+    ::_exit(15);
+  }
+  if (bench.coredump_filter >= 0 &&
+      !SetCoredumpFilter(static_cast<unsigned>(bench.coredump_filter), error)) {
+    ::_exit(13);
+  }
+  if (mode == DumpMode::kMinidump || mode == DumpMode::kMinidumpAndCore) {
+    crash_report::CrashReporterOptions options;
+    options.dump_path = kMinidumpName;
+    options.keep_kernel_core = mode == DumpMode::kMinidumpAndCore;
+    if (!crash_report::CrashReporter::Instance().Install(options, error)) {
+      ::_exit(11);
+    }
+  }
+
+  // 故意泄漏：崩溃时仍驻留，模拟大堆进程。非零填充保证每一页都真实分配。
+  unsigned char* heap = nullptr;
+  if (bench.heap == HeapPlacement::kDontDumpArena) {
+    static DumpArena arena;
+    if (!arena.Init(heap_bytes, DumpPolicy::kExclude, error)) {
+      ::_exit(14);
+    }
+    heap = static_cast<unsigned char*>(arena.Allocate(heap_bytes));
+  } else {
+    heap = new unsigned char[heap_bytes];
+  }
+  std::memset(heap, 0x5a, heap_bytes);
+  for (int i = 0; i < kParkedWorkers; ++i) {
+    std::thread(ParkForever).detach();
+  }
+  if (!async_log::Logger::Instance().InstallCrashFlush(error)) {
+    ::_exit(16);
+  }
+
+  int stack_marker = 0;
+  ReadyMessage ready;
+  ready.heap_address = reinterpret_cast<std::uint64_t>(heap + heap_bytes / 2);
+  ready.stack_address = reinterpret_cast<std::uint64_t>(&stack_marker);
+  ready.timestamp = Clock::now().time_since_epoch().count();
+  if (::write(ready_fd, &ready, sizeof(ready)) != sizeof(ready)) {
+    ::_exit(12);
+  }
+  A* obj = new B();
+  delete obj;
+  ::_exit(0);
+}
+
+std::uint64_t FileSize(const fs::path& path) {
+  std::error_code ec;
+  const auto size = fs::file_size(path, ec);
+  return ec ? 0 : static_cast<std::uint64_t>(size);
+}
+
+// 读 core 的程序头：address 所在的 PT_LOAD 段是否带有文件内容（p_filesz 覆盖到它）。
+Presence CheckCoreContains(const fs::path& core, std::uint64_t address) {
+  std::ifstream in(core, std::ios::binary);
+  Elf64_Ehdr ehdr{};
+  if (!in.read(reinterpret_cast<char*>(&ehdr), sizeof(ehdr)) ||
+      std::memcmp(ehdr.e_ident, ELFMAG, SELFMAG) != 0 || ehdr.e_type != ET_CORE) {
+    return Presence::kNoCore;
+  }
+  in.seekg(static_cast<std::streamoff>(ehdr.e_phoff));
+  for (int i = 0; i < ehdr.e_phnum; ++i) {
+    Elf64_Phdr phdr{};
+    if (!in.read(reinterpret_cast<char*>(&phdr), sizeof(phdr))) {
+      break;
+    }
+    if (phdr.p_type == PT_LOAD && address >= phdr.p_vaddr &&
+        address - phdr.p_vaddr < phdr.p_memsz) {
+      return address - phdr.p_vaddr < phdr.p_filesz ? Presence::kPresent : Presence::kMissing;
+    }
+  }
+  return Presence::kMissing;
+}
+
+const char* PresenceText(Presence presence) {
+  switch (presence) {
+    case Presence::kPresent:
+      return "yes";
+    case Presence::kMissing:
+      return "no";
+    default:
+      return "-";
+  }
+}
+
+bool RunRound(const BenchCase& bench, std::size_t heap_bytes, const fs::path& workdir,
+              RoundResult& result) {
+  fs::remove_all(workdir);
+  fs::create_directories(workdir);
+
+  int fds[2];
+  if (::pipe(fds) != 0) {
+    return false;
+  }
+  const pid_t pid = ::fork();
+  if (pid < 0) {
+    return false;
+  }
+  if (pid == 0) {
+    ::close(fds[0]);
+    RunChild(bench, heap_bytes, workdir, fds[1]);
+  }
+  ::close(fds[1]);
+
+  ReadyMessage ready;
+  const bool got_ready = ::read(fds[0], &ready, sizeof(ready)) == sizeof(ready);
+  ::close(fds[0]);
+  int status = 0;
+  ::waitpid(pid, &status, 0);
+  const std::int64_t done = Clock::now().time_since_epoch().count();
+  if (!got_ready) {
+    return false;
+  }
+
+  result.exit_ms =
+      std::chrono::duration<double, std::milli>(Clock::duration(done - ready.timestamp)).count();
+  result.signaled = WIFSIGNALED(status);
+  result.core_flag = result.signaled && WCOREDUMP(status);
+  fs::path core = workdir / "core";
+  if (!fs::exists(core)) {
+    core = workdir / ("core." + std::to_string(pid));
+  }
+  result.core_bytes = FileSize(core);
+  if (result.core_bytes != 0) {
+    result.heap = CheckCoreContains(core, ready.heap_address);
+    result.stack = CheckCoreContains(core, ready.stack_address);
+  }
+  result.minidump_bytes = FileSize(workdir / kMinidumpName);
+  fs::remove_all(workdir);
+  return true;
+}
+
+std::string ReadCorePattern() {
+  std::ifstream in("/proc/sys/kernel/core_pattern");
+  std::string pattern;
+  std::getline(in, pattern);
+  return pattern;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  const long heap_mb = argc >= 2 ? std::atol(argv[1]) : 256;
+  const int rounds = argc >= 3 ? std::atoi(argv[2]) : 3;
+  if (heap_mb <= 0 || rounds <= 0) {
+    std::cerr << "usage: " << argv[0] << " [heap_mb] [rounds]\n";
+    return 2;
+  }
+  const auto heap_bytes = static_cast<std::size_t>(heap_mb) << 20;
+  const fs::path workdir =
+      fs::canonical(fs::path(argv[0])).parent_path() / "crash_bench_work";
+
+  const std::string pattern = ReadCorePattern();
+  std::cout << "== time-to-exit after the B::~B() crash: kernel core, dump filters, minidump ==\n"
+            << heap_mb << " MiB touched heap, " << kParkedWorkers + 1
+            << " threads + async_log writer, median of "
+            << rounds << " rounds\n"
+            << "core_pattern = " << pattern << "\n";
+  if (pattern.empty() || pattern[0] == '|' || pattern.find('/') != std::string::npos) {
+    std::cout << "(core_pattern is not a plain file name in the cwd: core size shows as 0)\n";
+  }
+  std::cout << "time is from just before `delete obj` to waitpid() returning; "
+               "HEAP/STACK: is that memory in the core\n\n"
+            << std::left << std::setw(26) << "MODE" << std::right << std::setw(10) << "exit ms"
+            << std::setw(11) << "core MiB" << std::setw(14) << "minidump KiB" << std::setw(6)
+            << "HEAP" << std::setw(7) << "STACK" << std::setw(8) << "STATUS" << '\n';
+
+  for (const BenchCase& bench : kCases) {
+    std::vector<RoundResult> results;
+    for (int r = 0; r < rounds; ++r) {
+      RoundResult result;
+      if (!RunRound(bench, heap_bytes, workdir, result)) {
+        std::cerr << bench.name << ": child failed before the crash point\n";
+        return 1;
+      }
+      results.push_back(result);
+    }
+    std::sort(results.begin(), results.end(),
+              [](const RoundResult& a, const RoundResult& b) { return a.exit_ms < b.exit_ms; });
+    const RoundResult& median = results[results.size() / 2];
+    std::cout << std::left << std::setw(26) << bench.name << std::right << std::fixed
+              << std::setprecision(1) << std::setw(10) << median.exit_ms << std::setw(11)
+              << static_cast<double>(median.core_bytes) / (1u << 20) << std::setw(14)
+              << static_cast<double>(median.minidump_bytes) / 1024 << std::setw(6)
+              << PresenceText(median.heap) << std::setw(7) << PresenceText(median.stack)
+              << std::setw(8)
+              << (!median.signaled ? "exited" : (median.core_flag ? "core" : "signal")) << '\n';
+  }
+  return 0;
+}
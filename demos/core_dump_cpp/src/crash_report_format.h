@@ -0,0 +1,72 @@
+#pragma once
+
+#include <cstdint>
+
+/*
+ * crash_reporter 写出的 minidump 文件布局（小端，按本机结构体直接落盘）：
+ *
+ *   [DumpHeader][ThreadRecord x kMaxThreads][数据区：各线程栈内存 + /proc/self/maps 文本]
+ *
+ * 文件在 Install() 时按容量预分配并 mmap(MAP_SHARED)，崩溃时 handler 只往映射里写，
+ * 最后 ftruncate 到实际用量。complete 为 0 的文件表示进程没有崩溃或 handler 没有写完。
+ */
+namespace crash_report {
+
+constexpr char kDumpMagic[8] = {'C', 'D', 'M', 'I', 'N', 'I', '0', '1'};
+constexpr std::uint32_t kDumpVersion = 1;
+constexpr int kMaxThreads = 64;
+constexpr int kMaxFrames = 64;
+constexpr int kMaxRegisters = 34;
+
+// ThreadRecord::flags
+constexpr std::uint32_t kThreadCrashed = 1u << 0;
+// 在别的线程崩溃处理期间自己也崩溃了：只记录自身，不再等待它响应抓取信号。
+constexpr std::uint32_t kThreadSecondaryCrash = 1u << 1;
+// 栈内存复制短于 stack_bytes：先到了栈映射的末端（常见），或数据区已满（stack_size 为 0）。
+constexpr std::uint32_t kThreadStackTruncated = 1u << 2;
+
+struct ThreadRecord {
+  std::int32_t tid;
+  std::uint32_t flags;
+  char name[16];
+  std::uint64_t pc;
+  std::uint64_t sp;
+  std::uint64_t fp;
+  // 原样保存的通用寄存器：x86_64 为 gregs[NGREG]，aarch64 为 x0..x30, sp, pc, pstate。
+  std::uint32_t register_count;
+  std::uint32_t frame_count;
+  std::uint64_t registers[kMaxRegisters];
+  // 帧指针回溯结果，frames[0] 是 pc，其余是返回地址减 1。
+  std::uint64_t frames[kMaxFrames];
+  // 从 sp 附近复制的栈内存：stack_address 是它在原进程里的地址，stack_offset 是文件内偏移。
+  std::uint64_t stack_address;
+  std::uint64_t stack_offset;
+  std::uint64_t stack_size;
+};
+
+struct DumpHeader {
+  char magic[8];
+  std::uint32_t version;
+  std::uint32_t header_size;
+  // 最后写入：非 0 表示其余字段已经完整。
+  std::uint32_t complete;
+  // ELF e_machine：62 = x86_64，183 = aarch64。
+  std::uint32_t machine;
+  std::int32_t pid;
+  std::int32_t crash_tid;
+  std::int32_t signo;
+  std::int32_t code;
+  std::uint64_t fault_address;
+  std::uint64_t wall_time_ns;
+  // 从进入 handler 到 minidump 写完的耗时。
+  std::uint64_t dump_ns;
+  std::uint32_t thread_count;
+  // 收到抓取请求但在超时前没有响应的线程数。
+  std::uint32_t threads_missed;
+  std::uint64_t thread_table_offset;
+  std::uint64_t maps_offset;
+  std::uint64_t maps_size;
+  std::uint64_t used_bytes;
+};
+
+}  // namespace crash_report
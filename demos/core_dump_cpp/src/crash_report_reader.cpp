@@ -0,0 +1,150 @@
+#include "crash_report_format.h"
+#include "module_symbolizer.h"
+
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+namespace {
+
+using crash_report::DumpHeader;
+using crash_report::ThreadRecord;
+
+constexpr int kMaxScannedFrames = 16;
+// 帧指针回溯少于这个深度时，再扫描栈内存里指向代码段的值作为候选返回地址。
+constexpr std::uint32_t kScanBelowDepth = 3;
+
+constexpr const char* kX86Registers[] = {
+    "r8",  "r9",  "r10", "r11", "r12", "r13", "r14", "r15",    "rdi",    "rsi",     "rbp", "rbx",
+    "rdx", "rax", "rcx", "rsp", "rip", "efl", "csgsfs", "err", "trapno", "oldmask", "cr2"};
+
+const char* SignalName(int signo) {
+  switch (signo) {
+    case 6:
+      return "SIGABRT";
+    case 7:
+      return "SIGBUS";
+    case 11:
+      return "SIGSEGV";
+    default:
+      return "?";
+  }
+}
+
+void PrintRegisters(const DumpHeader& header, const ThreadRecord& thread) {
+  std::cout << "registers (thread " << thread.tid << "):\n" << std::hex;
+  for (std::uint32_t i = 0; i < thread.register_count && i < crash_report::kMaxRegisters; ++i) {
+    std::string name;
+    if (header.machine == 62 && i < std::size(kX86Registers)) {
+      name = kX86Registers[i];
+    } else if (header.machine == 183) {
+      name = i < 31 ? "x" + std::to_string(i) : (i == 31 ? "sp" : (i == 32 ? "pc" : "pstate"));
+    } else {
+      name = "r" + std::to_string(i);
+    }
+    std::cout << "  " << std::left << std::setw(8) << name << "0x" << std::right
+              << std::setw(16) << std::setfill('0') << thread.registers[i] << std::setfill(' ')
+              << (i % 3 == 2 ? "\n" : "");
+  }
+  std::cout << std::dec << "\n\n";
+}
+
+void PrintThread(const std::vector<char>& file, const ThreadRecord& thread,
+                 ModuleSymbolizer& symbolizer) {
+  std::cout << "thread " << thread.tid << " \""
+            << std::string(thread.name, strnlen(thread.name, sizeof(thread.name))) << '"';
+  if (thread.flags & crash_report::kThreadCrashed) {
+    std::cout << " [crashed]";
+  }
+  if (thread.flags & crash_report::kThreadSecondaryCrash) {
+    std::cout << " [secondary crash]";
+  }
+  std::cout << '\n';
+  for (std::uint32_t i = 0; i < thread.frame_count && i < crash_report::kMaxFrames; ++i) {
+    std::cout << "  #" << std::left << std::setw(3) << i << std::right << "0x" << std::hex
+              << std::setw(12) << std::setfill('0') << thread.frames[i] << std::setfill(' ')
+              << std::dec << "  " << symbolizer.Describe(thread.frames[i]) << '\n';
+  }
+
+  const bool stack_ok = thread.stack_size != 0 &&
+                        thread.stack_offset + thread.stack_size <= file.size();
+  if (stack_ok && thread.frame_count < kScanBelowDepth) {
+    // 栈扫描：可能包含已失效的旧返回地址，只作为帧指针回溯失败时的线索。
+    const auto* words = reinterpret_cast<const std::uint64_t*>(file.data() + thread.stack_offset);
+    int found = 0;
+    for (std::uint64_t i = 0; i < thread.stack_size / 8 && found < kMaxScannedFrames; ++i) {
+      if (symbolizer.IsCode(words[i])) {
+        std::cout << "  scan sp+0x" << std::hex << std::left << std::setw(6) << i * 8
+                  << std::right << std::dec << symbolizer.Describe(words[i] - 1) << '\n';
+        ++found;
+      }
+    }
+  }
+  std::cout << "  stack: " << thread.stack_size << " bytes copied from 0x" << std::hex
+            << thread.stack_address << std::dec
+            << (!(thread.flags & crash_report::kThreadStackTruncated)
+                    ? ""
+                    : (thread.stack_size != 0 ? " (reached end of stack mapping)"
+                                              : " (dump data area full)"))
+            << "\n\n";
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  if (argc != 2) {
+    std::cerr << "usage: " << argv[0] << " <minidump>\n";
+    return 2;
+  }
+  std::ifstream in(argv[1], std::ios::binary);
+  const std::vector<char> file((std::istreambuf_iterator<char>(in)),
+                               std::istreambuf_iterator<char>());
+  if (file.size() < sizeof(DumpHeader)) {
+    std::cerr << argv[1] << ": too small for a minidump\n";
+    return 1;
+  }
+  DumpHeader header{};
+  std::memcpy(&header, file.data(), sizeof(header));
+  if (std::memcmp(header.magic, crash_report::kDumpMagic, sizeof(header.magic)) != 0 ||
+      header.version != crash_report::kDumpVersion) {
+    std::cerr << argv[1] << ": not a crash_reporter minidump\n";
+    return 1;
+  }
+  if (header.complete == 0) {
+    std::cerr << argv[1] << ": dump is incomplete (process did not crash or handler died)\n";
+    return 1;
+  }
+  if (header.thread_table_offset + sizeof(ThreadRecord) * header.thread_count > file.size() ||
+      header.maps_offset + header.maps_size > file.size()) {
+    std::cerr << argv[1] << ": truncated\n";
+    return 1;
+  }
+
+  std::cout << "minidump " << argv[1] << ": " << file.size() << " bytes\n"
+            << "pid " << header.pid << ", crashed thread " << header.crash_tid << ", signal "
+            << header.signo << " (" << SignalName(header.signo) << ") code " << header.code
+            << ", fault address 0x" << std::hex << header.fault_address << std::dec << '\n'
+            << "written in " << header.dump_ns / 1000 << " us, " << header.thread_count
+            << " threads captured, " << header.threads_missed << " missed\n\n";
+
+  std::vector<ThreadRecord> threads(header.thread_count);
+  std::memcpy(threads.data(), file.data() + header.thread_table_offset,
+              sizeof(ThreadRecord) * threads.size());
+  ModuleSymbolizer symbolizer(
+      ParseProcMaps(std::string(file.data() + header.maps_offset, header.maps_size)));
+
+  for (const ThreadRecord& thread : threads) {
+    if (thread.tid == header.crash_tid) {
+      PrintRegisters(header, thread);
+      break;
+    }
+  }
+  for (const ThreadRecord& thread : threads) {
+    PrintThread(file, thread, symbolizer);
+  }
+  return 0;
+}
@@ -0,0 +1,522 @@
+#include "crash_reporter.h"
+
+#include <dirent.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/prctl.h>
+#include <sys/resource.h>
+#include <sys/syscall.h>
+#include <sys/uio.h>
+#include <ucontext.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstring>
+#include <ctime>
+
+namespace crash_report {
+
+namespace {
+
+constexpr int kCrashSignals[] = {SIGSEGV, SIGBUS, SIGABRT};
+constexpr std::size_t kPageSize = 4096;
+constexpr std::size_t kAltStackSize = 64u << 10;
+constexpr std::size_t kMaxStackBytes = 1u << 20;
+constexpr std::size_t kMapsBytes = 256u << 10;
+// 帧指针链只在 [sp, sp + kMaxStackSpan) 范围内追踪。
+constexpr std::uint64_t kMaxStackSpan = 8u << 20;
+#if defined(__x86_64__)
+// x86_64 的 red zone：sp 下方 128 字节仍可能存放叶子函数的局部变量。
+constexpr std::uint64_t kRedZone = 128;
+constexpr std::uint32_t kMachine = 62;
+#elif defined(__aarch64__)
+constexpr std::uint64_t kRedZone = 0;
+constexpr std::uint32_t kMachine = 183;
+#else
+constexpr std::uint64_t kRedZone = 0;
+constexpr std::uint32_t kMachine = 0;
+#endif
+
+std::uint64_t NowNs(clockid_t clock) {
+  timespec ts{};
+  ::clock_gettime(clock, &ts);
+  return static_cast<std::uint64_t>(ts.tv_sec) * 1000000000ull +
+         static_cast<std::uint64_t>(ts.tv_nsec);
+}
+
+int CurrentTid() {
+  return static_cast<int>(::syscall(SYS_gettid));
+}
+
+std::uint64_t AlignUp(std::uint64_t value, std::uint64_t align) {
+  return (value + align - 1) / align * align;
+}
+
+bool ReadMachineContext(void* ucontext, ThreadRecord& record) {
+  const auto* uc = static_cast<const ucontext_t*>(ucontext);
+#if defined(__x86_64__)
+  static_assert(NGREG <= kMaxRegisters, "register array too small");
+  for (int i = 0; i < NGREG; ++i) {
+    record.registers[i] = static_cast<std::uint64_t>(uc->uc_mcontext.gregs[i]);
+  }
+  record.register_count = NGREG;
+  record.pc = static_cast<std::uint64_t>(uc->uc_mcontext.gregs[REG_RIP]);
+  record.fp = static_cast<std::uint64_t>(uc->uc_mcontext.gregs[REG_RBP]);
+  record.sp = static_cast<std::uint64_t>(uc->uc_mcontext.gregs[REG_RSP]);
+  return true;
+#elif defined(__aarch64__)
+  for (int i = 0; i < 31; ++i) {
+    record.registers[i] = uc->uc_mcontext.regs[i];
+  }
+  record.registers[31] = uc->uc_mcontext.sp;
+  record.registers[32] = uc->uc_mcontext.pc;
+  record.registers[33] = uc->uc_mcontext.pstate;
+  record.register_count = 34;
+  record.pc = uc->uc_mcontext.pc;
+  record.fp = uc->uc_mcontext.regs[29];
+  record.sp = uc->uc_mcontext.sp;
+  return true;
+#else
+  (void)uc;
+  (void)record;
+  return false;
+#endif
+}
+
+/*
+ * 通过 process_vm_readv 读自己的内存：地址无效时返回错误而不是触发 SIGSEGV。
+ * 按页拆成多个 iovec，跨过未映射页时能拿到前面已读到的部分。
+ */
+std::size_t SafeRead(std::uint64_t address, void* dst, std::size_t bytes) {
+  constexpr int kMaxIov = static_cast<int>(kMaxStackBytes / kPageSize) + 1;
+  iovec local[kMaxIov];
+  iovec remote[kMaxIov];
+  int count = 0;
+  std::size_t done = 0;
+  while (done < bytes && count < kMaxIov) {
+    const std::uint64_t at = address + done;
+    std::size_t chunk = kPageSize - static_cast<std::size_t>(at % kPageSize);
+    if (chunk > bytes - done) {
+      chunk = bytes - done;
+    }
+    local[count].iov_base = static_cast<unsigned char*>(dst) + done;
+    local[count].iov_len = chunk;
+    remote[count].iov_base = reinterpret_cast<void*>(at);
+    remote[count].iov_len = chunk;
+    ++count;
+    done += chunk;
+  }
+  const ssize_t n = ::process_vm_readv(::getpid(), local, count, remote, count, 0);
+  return n > 0 ? static_cast<std::size_t>(n) : 0;
+}
+
+int WalkFramePointers(const ThreadRecord& record, std::uint64_t* frames, int max_frames) {
+  int depth = 0;
+  frames[depth++] = record.pc;
+  std::uint64_t fp = record.fp;
+  // 帧布局：[fp] = 上一帧 fp，[fp + 8] = 返回地址。要求 fp 单调递增且不越出栈范围。
+  while (depth < max_frames) {
+    if (fp < record.sp || fp - record.sp >= kMaxStackSpan || fp % sizeof(std::uint64_t) != 0) {
+      break;
+    }
+    std::uint64_t frame[2] = {};
+    if (SafeRead(fp, frame, sizeof(frame)) != sizeof(frame) || frame[1] == 0) {
+      break;
+    }
+    // 返回地址减 1 落回 call 指令内部，符号化时才会归到调用者。
+    frames[depth++] = frame[1] - 1;
+    if (frame[0] <= fp) {
+      break;
+    }
+    fp = frame[0];
+  }
+  return depth;
+}
+
+// handler 里用的定长行缓冲：只做字符串与整数拼接，最后一次 write(2)。
+class LineWriter final {
+ public:
+  LineWriter& Str(const char* text) {
+    while (*text != '\0' && size_ < sizeof(buf_)) {
+      buf_[size_++] = *text++;
+    }
+    return *this;
+  }
+
+  LineWriter& Dec(std::uint64_t value) {
+    char digits[24];
+    int n = 0;
+    do {
+      digits[n++] = static_cast<char>('0' + value % 10);
+      value /= 10;
+    } while (value != 0);
+    while (n > 0 && size_ < sizeof(buf_)) {
+      buf_[size_++] = digits[--n];
+    }
+    return *this;
+  }
+
+  LineWriter& Hex(std::uint64_t value) {
+    Str("0x");
+    char digits[16];
+    int n = 0;
+    do {
+      digits[n++] = "0123456789abcdef"[value & 0xf];
+      value >>= 4;
+    } while (value != 0);
+    while (n > 0 && size_ < sizeof(buf_)) {
+      buf_[size_++] = digits[--n];
+    }
+    return *this;
+  }
+
+  void Write(int fd) const {
+    std::size_t done = 0;
+    while (done < size_) {
+      const ssize_t n = ::write(fd, buf_ + done, size_ - done);
+      if (n <= 0) {
+        break;
+      }
+      done += static_cast<std::size_t>(n);
+    }
+  }
+
+ private:
+  char buf_[512];
+  std::size_t size_ = 0;
+};
+
+int SignalIndex(int sig) {
+  for (int i = 0; i < 3; ++i) {
+    if (kCrashSignals[i] == sig) {
+      return i;
+    }
+  }
+  return -1;
+}
+
+}  // namespace
+
+CrashReporter& CrashReporter::Instance() {
+  // 故意不释放：崩溃可能发生在静态析构阶段。
+  static CrashReporter* instance = new CrashReporter();
+  return *instance;
+}
+
+int CrashReporter::CaptureSignal() {
+  return SIGRTMIN + 3;
+}
+
+bool CrashReporter::Install(const CrashReporterOptions& options, std::string& error) {
+  if (installed()) {
+    error = "crash reporter already installed";
+    return false;
+  }
+  if (options.dump_path.empty()) {
+    error = "dump path is empty";
+    return false;
+  }
+  if (options.stack_bytes < kPageSize || options.stack_bytes > kMaxStackBytes) {
+    error = "stack bytes must be in [4KiB, 1MiB]";
+    return false;
+  }
+  const std::uint64_t data_start =
+      AlignUp(sizeof(DumpHeader) + sizeof(ThreadRecord) * kMaxThreads, kPageSize);
+  if (options.capacity_bytes < data_start + options.stack_bytes) {
+    error = "capacity too small for header, thread table and one stack";
+    return false;
+  }
+  capture_signal_ = CaptureSignal();
+  if (capture_signal_ > SIGRTMAX) {
+    error = "no realtime signal available for thread capture";
+    return false;
+  }
+
+  options_ = options;
+  options_.stack_bytes = AlignUp(options.stack_bytes, kPageSize);
+  capacity_ = options.capacity_bytes;
+
+  // 文件空间在安装时就分配好：MAP_SHARED 映射写到磁盘满的页会收到 SIGBUS。
+  fd_ = ::open(options_.dump_path.c_str(), O_RDWR | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+  if (fd_ < 0) {
+    error = "open " + options_.dump_path + ": " + std::strerror(errno);
+    return false;
+  }
+  int rc = ::posix_fallocate(fd_, 0, static_cast<off_t>(capacity_));
+  if (rc == EOPNOTSUPP || rc == EINVAL) {
+    rc = ::ftruncate(fd_, static_cast<off_t>(capacity_)) == 0 ? 0 : errno;
+  }
+  if (rc != 0) {
+    error = "reserve " + options_.dump_path + ": " + std::strerror(rc);
+    ::close(fd_);
+    fd_ = -1;
+    return false;
+  }
+  void* mapped = ::mmap(nullptr, capacity_, PROT_READ | PROT_WRITE, MAP_SHARED, fd_, 0);
+  if (mapped == MAP_FAILED) {
+    error = std::string("mmap dump file: ") + std::strerror(errno);
+    ::close(fd_);
+    fd_ = -1;
+    return false;
+  }
+  base_ = static_cast<unsigned char*>(mapped);
+  // 头部与线程表提前写一遍，让这些页在崩溃前就已驻留。
+  std::memset(base_, 0, data_start);
+
+  auto* header = reinterpret_cast<DumpHeader*>(base_);
+  std::memcpy(header->magic, kDumpMagic, sizeof(kDumpMagic));
+  header->version = kDumpVersion;
+  header->header_size = sizeof(DumpHeader);
+  header->machine = kMachine;
+  header->thread_table_offset = sizeof(DumpHeader);
+  data_cursor_.store(data_start, std::memory_order_relaxed);
+
+  if (!RegisterCurrentThread(error)) {
+    return false;
+  }
+
+  struct sigaction capture {};
+  capture.sa_sigaction = &CrashReporter::OnCaptureSignal;
+  capture.sa_flags = SA_SIGINFO | SA_RESTART;
+  sigemptyset(&capture.sa_mask);
+  if (::sigaction(capture_signal_, &capture, nullptr) != 0) {
+    error = std::string("sigaction(capture): ") + std::strerror(errno);
+    return false;
+  }
+
+  // 处理期间屏蔽其他崩溃信号与抓取信号：handler 自己再出错时由内核按默认动作终止进程。
+  struct sigaction crash {};
+  crash.sa_sigaction = &CrashReporter::OnCrashSignal;
+  crash.sa_flags = SA_SIGINFO | SA_ONSTACK;
+  sigemptyset(&crash.sa_mask);
+  sigaddset(&crash.sa_mask, capture_signal_);
+  for (const int sig : kCrashSignals) {
+    sigaddset(&crash.sa_mask, sig);
+  }
+  for (int i = 0; i < 3; ++i) {
+    if (::sigaction(kCrashSignals[i], &crash, &previous_actions_[i]) != 0) {
+      error = std::string("sigaction: ") + std::strerror(errno);
+      return false;
+    }
+  }
+  installed_.store(true, std::memory_order_release);
+  return true;
+}
+
+bool CrashReporter::RegisterCurrentThread(std::string& error) {
+  stack_t current{};
+  if (::sigaltstack(nullptr, &current) == 0 && (current.ss_flags & SS_DISABLE) == 0) {
+    return true;
+  }
+  // 线程退出时不回收：altstack 只有几十 KiB，而 handler 随时可能用到它。
+  void* memory = ::mmap(nullptr, kAltStackSize, PROT_READ | PROT_WRITE,
+                        MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+  if (memory == MAP_FAILED) {
+    error = std::string("mmap altstack: ") + std::strerror(errno);
+    return false;
+  }
+  stack_t stack{};
+  stack.ss_sp = memory;
+  stack.ss_size = kAltStackSize;
+  if (::sigaltstack(&stack, nullptr) != 0) {
+    error = std::string("sigaltstack: ") + std::strerror(errno);
+    ::munmap(memory, kAltStackSize);
+    return false;
+  }
+  return true;
+}
+
+void CrashReporter::OnCrashSignal(int sig, siginfo_t* info, void* ucontext) {
+  Instance().HandleCrash(sig, info, ucontext);
+}
+
+void CrashReporter::OnCaptureSignal(int /*sig*/, siginfo_t* /*info*/, void* ucontext) {
+  const int saved_errno = errno;
+  CrashReporter& self = Instance();
+  if (self.crashing_tid_.load(std::memory_order_acquire) == 0) {
+    errno = saved_errno;
+    return;
+  }
+  self.CaptureThread(CurrentTid(), ucontext, 0);
+  self.captured_.fetch_add(1, std::memory_order_release);
+  // 原地挂起，直到崩溃线程重新触发信号结束整个进程。
+  for (;;) {
+    ::pause();
+  }
+}
+
+std::uint64_t CrashReporter::ReserveData(std::uint64_t bytes) {
+  const std::uint64_t offset = data_cursor_.fetch_add(bytes, std::memory_order_relaxed);
+  return offset + bytes <= capacity_ ? offset : 0;
+}
+
+void CrashReporter::CaptureThread(int tid, void* ucontext, std::uint32_t flags) {
+  const int slot = next_thread_.fetch_add(1, std::memory_order_relaxed);
+  if (slot >= kMaxThreads) {
+    return;
+  }
+  auto* record = reinterpret_cast<ThreadRecord*>(base_ + sizeof(DumpHeader)) + slot;
+  record->tid = tid;
+  record->flags = flags;
+  ::prctl(PR_GET_NAME, record->name, 0, 0, 0);
+  if (!ReadMachineContext(ucontext, *record)) {
+    return;
+  }
+  record->frame_count =
+      static_cast<std::uint32_t>(WalkFramePointers(*record, record->frames, kMaxFrames));
+
+  const std::uint64_t address = (record->sp - kRedZone) & ~std::uint64_t{15};
+  const std::uint64_t offset = ReserveData(options_.stack_bytes);
+  if (offset == 0) {
+    record->flags |= kThreadStackTruncated;
+    return;
+  }
+  const std::size_t copied = SafeRead(address, base_ + offset, options_.stack_bytes);
+  record->stack_address = address;
+  record->stack_offset = offset;
+  record->stack_size = copied;
+  if (copied < options_.stack_bytes) {
+    record->flags |= kThreadStackTruncated;
+  }
+}
+
+int CrashReporter::SignalOtherThreads(int self_tid) {
+  const int dir = ::open("/proc/self/task", O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+  if (dir < 0) {
+    return 0;
+  }
+  const pid_t pid = ::getpid();
+  int requested = 0;
+  alignas(8) char buf[4096];
+  for (;;) {
+    const long n = ::syscall(SYS_getdents64, dir, buf, sizeof(buf));
+    if (n <= 0) {
+      break;
+    }
+    for (long pos = 0; pos < n;) {
+      const auto* entry = reinterpret_cast<const dirent64*>(buf + pos);
+      pos += entry->d_reclen;
+      int tid = 0;
+      const char* name = entry->d_name;
+      if (*name < '0' || *name > '9') {
+        continue;
+      }
+      for (; *name >= '0' && *name <= '9'; ++name) {
+        tid = tid * 10 + (*name - '0');
+      }
+      if (tid != self_tid && ::syscall(SYS_tgkill, pid, tid, capture_signal_) == 0) {
+        ++requested;
+      }
+    }
+  }
+  ::close(dir);
+  return requested;
+}
+
+void CrashReporter::CaptureMaps() {
+  auto* header = reinterpret_cast<DumpHeader*>(base_);
+  std::uint64_t reserve = kMapsBytes;
+  const std::uint64_t cursor = data_cursor_.load(std::memory_order_relaxed);
+  if (cursor >= capacity_) {
+    return;
+  }
+  if (cursor + reserve > capacity_) {
+    reserve = capacity_ - cursor;
+  }
+  const std::uint64_t offset = ReserveData(reserve);
+  const int fd = ::open("/proc/self/maps", O_RDONLY | O_CLOEXEC);
+  if (offset == 0 || fd < 0) {
+    return;
+  }
+  std::uint64_t size = 0;
+  while (size < reserve) {
+    const ssize_t n = ::read(fd, base_ + offset + size, reserve - size);
+    if (n <= 0) {
+      break;
+    }
+    size += static_cast<std::uint64_t>(n);
+  }
+  ::close(fd);
+  header->maps_offset = offset;
+  header->maps_size = size;
+}
+
+void CrashReporter::HandleCrash(int sig, siginfo_t* info, void* ucontext) {
+  const std::uint64_t begin = NowNs(CLOCK_MONOTONIC);
+  const int self = CurrentTid();
+  int expected = 0;
+  if (!crashing_tid_.compare_exchange_strong(expected, self, std::memory_order_acq_rel)) {
+    // 另一个线程已经在写 dump：只记录自己，然后等它结束进程。
+    CaptureThread(self, ucontext, kThreadCrashed | kThreadSecondaryCrash);
+    for (;;) {
+      ::pause();
+    }
+  }
+
+  CaptureThread(self, ucontext, kThreadCrashed);
+  const int requested = SignalOtherThreads(self);
+  const std::uint64_t deadline =
+      begin + static_cast<std::uint64_t>(options_.thread_timeout_ms) * 1000000ull;
+  while (captured_.load(std::memory_order_acquire) < requested &&
+         NowNs(CLOCK_MONOTONIC) < deadline) {
+    const timespec nap{0, 50000};
+    ::nanosleep(&nap, nullptr);
+  }
+  const int captured = captured_.load(std::memory_order_acquire);
+  CaptureMaps();
+
+  auto* header = reinterpret_cast<DumpHeader*>(base_);
+  const int threads = next_thread_.load(std::memory_order_relaxed);
+  const std::uint64_t cursor = data_cursor_.load(std::memory_order_relaxed);
+  header->pid = ::getpid();
+  header->crash_tid = self;
+  header->signo = sig;
+  header->code = info != nullptr ? info->si_code : 0;
+  // si_addr 只对硬件异常有意义；kill/abort 发来的信号同一位置存的是发送方 pid。
+  header->fault_address =
+      info != nullptr && info->si_code > 0 ? reinterpret_cast<std::uint64_t>(info->si_addr) : 0;
+  header->wall_time_ns = NowNs(CLOCK_REALTIME);
+  header->thread_count = static_cast<std::uint32_t>(threads < kMaxThreads ? threads : kMaxThreads);
+  header->threads_missed = static_cast<std::uint32_t>(requested - captured);
+  header->used_bytes = cursor < capacity_ ? cursor : capacity_;
+  header->dump_ns = NowNs(CLOCK_MONOTONIC) - begin;
+  std::atomic_thread_fence(std::memory_order_release);
+  header->complete = 1;
+  // MAP_SHARED 的页在进程死后仍留在页缓存里，不需要 msync；截断到实际用量即可。
+  ::ftruncate(fd_, static_cast<off_t>(header->used_bytes));
+
+  LineWriter()
+      .Str("[crash_reporter] signal ")
+      .Dec(static_cast<std::uint64_t>(sig))
+      .Str(" at ")
+      .Hex(header->fault_address)
+      .Str(", minidump ")
+      .Str(options_.dump_path.c_str())
+      .Str(" (")
+      .Dec(header->used_bytes)
+      .Str(" bytes, ")
+      .Dec(header->thread_count)
+      .Str(" threads, ")
+      .Dec(header->dump_ns / 1000)
+      .Str(" us)\n")
+      .Write(STDERR_FILENO);
+
+  if (!options_.keep_kernel_core) {
+    rlimit limit{};
+    ::getrlimit(RLIMIT_CORE, &limit);
+    limit.rlim_cur = 0;
+    ::setrlimit(RLIMIT_CORE, &limit);
+  }
+
+  // 恢复原来的处理方式：硬件异常返回后会在同一条指令上再次触发，
+  // abort()/kill 这类主动发送的信号则需要自己再发一次（当前被屏蔽，返回后送达）。
+  const int index = SignalIndex(sig);
+  if (index >= 0) {
+    ::sigaction(sig, &previous_actions_[index], nullptr);
+  }
+  if (info == nullptr || info->si_code <= 0) {
+    ::syscall(SYS_tgkill, ::getpid(), self, sig);
+  }
+}
+
+}  // namespace crash_report
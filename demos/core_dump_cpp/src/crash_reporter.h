@@ -0,0 +1,81 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+#include <csignal>
+
+#include "crash_report_format.h"
+
+namespace crash_report {
+
+struct CrashReporterOptions {
+  // minidump 文件路径；每次 Install() 都会截断重建，重启前应由 supervisor 先取走上一份。
+  std::string dump_path;
+  // 预分配的文件容量，数据写满后后续线程的栈内存会被截断。
+  std::size_t capacity_bytes = 4u << 20;
+  // 每个线程从 sp 起复制的栈内存字节数。
+  std::size_t stack_bytes = 16u << 10;
+  // 等待其他线程响应抓取信号的上限。
+  int thread_timeout_ms = 200;
+  // false：写完 minidump 后把 RLIMIT_CORE 置 0，进程不再由内核写完整 core。
+  bool keep_kernel_core = false;
+};
+
+/*
+ * 进程内崩溃报告器，作为完整 kernel core 之外的快速选项。
+ * - Install() 预分配并 mmap 好 minidump 文件、为调用线程准备 sigaltstack，
+ *   再为 SIGSEGV / SIGBUS / SIGABRT 安装 handler（SA_ONSTACK）。
+ * - 崩溃线程在 handler 里记录自己的寄存器、帧指针回溯和 sp 附近的栈内存，
+ *   再用 tgkill 给 /proc/self/task 下的其他线程发抓取信号，由它们各自记录后原地挂起。
+ * - handler 里不分配内存、不加锁：槽位与数据区都靠原子 fetch_add 领取，
+ *   读内存统一走 process_vm_readv，碰到未映射地址只会返回错误而不会二次崩溃。
+ * - 写完后恢复默认处理并重新触发原信号，进程仍以原信号退出，supervisor 看到的结果不变。
+ * - 回溯依赖帧指针，目标代码需要 -fno-omit-frame-pointer（-O0 默认保留）。
+ */
+class CrashReporter final {
+ public:
+  static CrashReporter& Instance();
+
+  bool Install(const CrashReporterOptions& options, std::string& error);
+
+  // 为调用线程准备 sigaltstack；需要在栈溢出时也能写 dump 的线程各调用一次。
+  bool RegisterCurrentThread(std::string& error);
+
+  bool installed() const { return installed_.load(std::memory_order_acquire); }
+
+  // 逐线程抓现场用的实时信号。其他组件的内部线程若屏蔽了它，崩溃时只能等到超时。
+  static int CaptureSignal();
+
+ private:
+  CrashReporter() = default;
+  CrashReporter(const CrashReporter&) = delete;
+  CrashReporter& operator=(const CrashReporter&) = delete;
+
+  static void OnCrashSignal(int sig, siginfo_t* info, void* ucontext);
+  static void OnCaptureSignal(int sig, siginfo_t* info, void* ucontext);
+
+  void HandleCrash(int sig, siginfo_t* info, void* ucontext);
+  void CaptureThread(int tid, void* ucontext, std::uint32_t flags);
+  int SignalOtherThreads(int self_tid);
+  void CaptureMaps();
+  std::uint64_t ReserveData(std::uint64_t bytes);
+
+  CrashReporterOptions options_;
+  int fd_ = -1;
+  unsigned char* base_ = nullptr;
+  std::size_t capacity_ = 0;
+  int capture_signal_ = 0;
+
+  std::atomic<bool> installed_{false};
+  std::atomic<int> crashing_tid_{0};
+  std::atomic<int> next_thread_{0};
+  std::atomic<int> captured_{0};
+  std::atomic<std::uint64_t> data_cursor_{0};
+
+  struct sigaction previous_actions_[3] {};
+};
+
+}  // namespace crash_report
@@ -0,0 +1,117 @@
+#include "dump_arena.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+namespace {
+
+std::size_t PageSize() {
+  static const std::size_t page = static_cast<std::size_t>(::sysconf(_SC_PAGESIZE));
+  return page;
+}
+
+}  // namespace
+
+bool SetDumpPolicy(void* address, std::size_t bytes, DumpPolicy policy, std::string& error) {
+  const int advice = policy == DumpPolicy::kExclude ? MADV_DONTDUMP : MADV_DODUMP;
+  if (::madvise(address, bytes, advice) != 0) {
+    error = std::string(policy == DumpPolicy::kExclude ? "madvise(MADV_DONTDUMP): "
+                                                       : "madvise(MADV_DODUMP): ") +
+            std::strerror(errno);
+    return false;
+  }
+  return true;
+}
+
+bool SetCoredumpFilter(unsigned mask, std::string& error) {
+  const int fd = ::open("/proc/self/coredump_filter", O_WRONLY | O_CLOEXEC);
+  if (fd < 0) {
+    error = std::string("open /proc/self/coredump_filter: ") + std::strerror(errno);
+    return false;
+  }
+  char text[16];
+  const int length = std::snprintf(text, sizeof(text), "0x%x", mask);
+  const bool ok = ::write(fd, text, static_cast<std::size_t>(length)) == length;
+  if (!ok) {
+    error = std::string("write /proc/self/coredump_filter: ") + std::strerror(errno);
+  }
+  ::close(fd);
+  return ok;
+}
+
+bool ReadCoredumpFilter(unsigned& mask, std::string& error) {
+  const int fd = ::open("/proc/self/coredump_filter", O_RDONLY | O_CLOEXEC);
+  if (fd < 0) {
+    error = std::string("open /proc/self/coredump_filter: ") + std::strerror(errno);
+    return false;
+  }
+  char text[32] = {};
+  const ssize_t n = ::read(fd, text, sizeof(text) - 1);
+  ::close(fd);
+  if (n <= 0) {
+    error = "read /proc/self/coredump_filter failed";
+    return false;
+  }
+  mask = static_cast<unsigned>(std::strtoul(text, nullptr, 16));
+  return true;
+}
+
+DumpArena::~DumpArena() {
+  if (base_ != nullptr) {
+    ::munmap(base_, capacity_);
+  }
+}
+
+bool DumpArena::Init(std::size_t capacity, DumpPolicy policy, std::string& error) {
+  if (base_ != nullptr) {
+    error = "arena already initialized";
+    return false;
+  }
+  if (capacity == 0) {
+    error = "arena capacity must be positive";
+    return false;
+  }
+  const std::size_t page = PageSize();
+  const std::size_t rounded = (capacity + page - 1) / page * page;
+  // 独立映射而不是从 malloc 取：madvise 以页为单位，且不能误伤与其他对象共页的元数据。
+  void* memory = ::mmap(nullptr, rounded, PROT_READ | PROT_WRITE,
+                        MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+  if (memory == MAP_FAILED) {
+    error = std::string("mmap arena: ") + std::strerror(errno);
+    return false;
+  }
+  base_ = static_cast<unsigned char*>(memory);
+  capacity_ = rounded;
+  used_ = 0;
+  policy_ = DumpPolicy::kInclude;
+  return policy == DumpPolicy::kInclude || SetPolicy(policy, error);
+}
+
+void* DumpArena::Allocate(std::size_t bytes, std::size_t align) {
+  const auto base = reinterpret_cast<std::uintptr_t>(base_);
+  const std::uintptr_t start = (base + used_ + align - 1) / align * align;
+  if (base_ == nullptr || start - base > capacity_ || bytes > capacity_ - (start - base)) {
+    return nullptr;
+  }
+  used_ = start - base + bytes;
+  return reinterpret_cast<void*>(start);
+}
+
+bool DumpArena::SetPolicy(DumpPolicy policy, std::string& error) {
+  if (base_ == nullptr) {
+    error = "arena not initialized";
+    return false;
+  }
+  if (!SetDumpPolicy(base_, capacity_, policy, error)) {
+    return false;
+  }
+  policy_ = policy;
+  return true;
+}
@@ -0,0 +1,91 @@
+#pragma once
+
+#include <cstddef>
+#include <new>
+#include <string>
+
+/*
+ * 控制哪些内存会进入 kernel core。
+ * - SetDumpPolicy：对一段页对齐的地址范围做 madvise(MADV_DONTDUMP / MADV_DODUMP)，按区域精确排除。
+ * - SetCoredumpFilter：写 /proc/self/coredump_filter，按映射类型（匿名私有、文件共享……）整类排除，
+ *   粒度很粗：堆和线程栈都是匿名私有映射，排除堆的同时也会丢掉栈。
+ * - DumpArena：一块独立 mmap 的区域做 bump 分配，整块统一打标记。大块业务数据（缓存、索引）
+ *   放进去后，core 里只剩真正用于定位问题的栈、小对象和元数据。
+ */
+
+enum class DumpPolicy {
+  kInclude,
+  kExclude,
+};
+
+bool SetDumpPolicy(void* address, std::size_t bytes, DumpPolicy policy, std::string& error);
+
+// mask 是 core(5) 里的位掩码，例如默认值 0x33；只影响本进程和之后 fork 出的子进程。
+bool SetCoredumpFilter(unsigned mask, std::string& error);
+bool ReadCoredumpFilter(unsigned& mask, std::string& error);
+
+// 非线程安全：预期由一个加载线程填充大块数据，之后只读。
+class DumpArena final {
+ public:
+  DumpArena() = default;
+  DumpArena(const DumpArena&) = delete;
+  DumpArena& operator=(const DumpArena&) = delete;
+  ~DumpArena();
+
+  bool Init(std::size_t capacity, DumpPolicy policy, std::string& error);
+
+  // 容量不足时返回 nullptr；内存随 arena 一起释放，不支持单独归还。
+  void* Allocate(std::size_t bytes, std::size_t align = alignof(std::max_align_t));
+
+  // 整块切换是否写入 core，例如在排查数据问题时临时改回 kInclude。
+  bool SetPolicy(DumpPolicy policy, std::string& error);
+
+  DumpPolicy policy() const { return policy_; }
+  std::size_t used() const { return used_; }
+  std::size_t capacity() const { return capacity_; }
+
+ private:
+  unsigned char* base_ = nullptr;
+  std::size_t capacity_ = 0;
+  std::size_t used_ = 0;
+  DumpPolicy policy_ = DumpPolicy::kInclude;
+};
+
+// 让标准容器从 DumpArena 取内存：std::vector<Row, ArenaAllocator<Row>> rows(ArenaAllocator<Row>(&arena));
+template <typename T>
+class ArenaAllocator {
+ public:
+  using value_type = T;
+
+  explicit ArenaAllocator(DumpArena* arena) : arena_(arena) {}
+
+  template <typename U>
+  ArenaAllocator(const ArenaAllocator<U>& other) : arena_(other.arena()) {}
+
+  T* allocate(std::size_t n) {
+    void* memory = n > static_cast<std::size_t>(-1) / sizeof(T)
+                       ? nullptr
+                       : arena_->Allocate(n * sizeof(T), alignof(T));
+    if (memory == nullptr) {
+      throw std::bad_alloc();
+    }
+    return static_cast<T*>(memory);
+  }
+
+  void deallocate(T*, std::size_t) {}
+
+  DumpArena* arena() const { return arena_; }
+
+ private:
+  DumpArena* arena_;
+};
+
+template <typename T, typename U>
+bool operator==(const ArenaAllocator<T>& a, const ArenaAllocator<U>& b) {
+  return a.arena() == b.arena();
+}
+
+template <typename T, typename U>
+bool operator!=(const ArenaAllocator<T>& a, const ArenaAllocator<U>& b) {
+  return !(a == b);
+}
@@ -0,0 +1,161 @@
+#include "elf_symbolizer.h"
+
+#include <cxxabi.h>
+#include <elf.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+
+namespace {
+
+std::string Demangle(const char* name) {
+  int status = 0;
+  char* demangled = abi::__cxa_demangle(name, nullptr, nullptr, &status);
+  if (status != 0 || demangled == nullptr) {
+    return name;
+  }
+  std::string result(demangled);
+  std::free(demangled);
+  return result;
+}
+
+}  // namespace
+
+std::string FindGnuBuildId(const unsigned char* notes, std::uint64_t size) {
+  static const char kHex[] = "0123456789abcdef";
+  std::uint64_t pos = 0;
+  while (pos + sizeof(Elf64_Nhdr) <= size) {
+    Elf64_Nhdr nhdr{};
+    std::memcpy(&nhdr, notes + pos, sizeof(nhdr));
+    const std::uint64_t name_at = pos + sizeof(nhdr);
+    const std::uint64_t desc_at = name_at + ((nhdr.n_namesz + 3u) & ~3u);
+    pos = desc_at + ((nhdr.n_descsz + 3u) & ~3u);
+    if (pos > size) {
+      break;
+    }
+    if (nhdr.n_type == NT_GNU_BUILD_ID && nhdr.n_namesz == 4 &&
+        std::memcmp(notes + name_at, "GNU", 4) == 0 && nhdr.n_descsz > 0) {
+      std::string id;
+      for (std::uint32_t i = 0; i < nhdr.n_descsz; ++i) {
+        id += kHex[notes[desc_at + i] >> 4];
+        id += kHex[notes[desc_at + i] & 0xf];
+      }
+      return id;
+    }
+  }
+  return std::string();
+}
+
+bool ElfSymbolizer::Load(const std::string& path, std::string& error) {
+  symbols_.clear();
+  segments_.clear();
+  build_id_.clear();
+
+  const int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+  if (fd < 0) {
+    error = "open " + path + ": " + std::strerror(errno);
+    return false;
+  }
+  struct stat st {};
+  if (::fstat(fd, &st) != 0 || static_cast<std::size_t>(st.st_size) < sizeof(Elf64_Ehdr)) {
+    error = path + ": not an ELF file";
+    ::close(fd);
+    return false;
+  }
+  const auto size = static_cast<std::size_t>(st.st_size);
+  void* mapped = ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+  ::close(fd);
+  if (mapped == MAP_FAILED) {
+    error = "mmap " + path + ": " + std::strerror(errno);
+    return false;
+  }
+  const auto* data = static_cast<const unsigned char*>(mapped);
+  const auto* ehdr = reinterpret_cast<const Elf64_Ehdr*>(data);
+  const auto in_file = [size](std::uint64_t offset, std::uint64_t bytes) {
+    return offset <= size && bytes <= size - offset;
+  };
+
+  bool ok = std::memcmp(ehdr->e_ident, ELFMAG, SELFMAG) == 0 &&
+            ehdr->e_ident[EI_CLASS] == ELFCLASS64 &&
+            in_file(ehdr->e_phoff, std::uint64_t{ehdr->e_phnum} * sizeof(Elf64_Phdr)) &&
+            in_file(ehdr->e_shoff, std::uint64_t{ehdr->e_shnum} * sizeof(Elf64_Shdr));
+  if (!ok) {
+    error = path + ": not a 64-bit ELF file";
+    ::munmap(mapped, size);
+    return false;
+  }
+
+  const auto* phdrs = reinterpret_cast<const Elf64_Phdr*>(data + ehdr->e_phoff);
+  for (int i = 0; i < ehdr->e_phnum; ++i) {
+    if (phdrs[i].p_type == PT_LOAD) {
+      segments_.push_back({phdrs[i].p_offset, phdrs[i].p_vaddr, phdrs[i].p_filesz});
+    } else if (phdrs[i].p_type == PT_NOTE && build_id_.empty() &&
+               in_file(phdrs[i].p_offset, phdrs[i].p_filesz)) {
+      build_id_ = FindGnuBuildId(data + phdrs[i].p_offset, phdrs[i].p_filesz);
+    }
+  }
+
+  // 优先 .symtab（含静态函数），剥离过的文件只剩 .dynsym。
+  const auto* shdrs = reinterpret_cast<const Elf64_Shdr*>(data + ehdr->e_shoff);
+  const Elf64_Shdr* table = nullptr;
+  for (const std::uint32_t wanted : {SHT_SYMTAB, SHT_DYNSYM}) {
+    for (int i = 0; i < ehdr->e_shnum && table == nullptr; ++i) {
+      if (shdrs[i].sh_type == wanted) {
+        table = &shdrs[i];
+      }
+    }
+  }
+  if (table != nullptr && table->sh_link < ehdr->e_shnum &&
+      in_file(table->sh_offset, table->sh_size)) {
+    const Elf64_Shdr& strings = shdrs[table->sh_link];
+    const auto* syms = reinterpret_cast<const Elf64_Sym*>(data + table->sh_offset);
+    const std::size_t count = table->sh_size / sizeof(Elf64_Sym);
+    for (std::size_t i = 0; i < count && in_file(strings.sh_offset, strings.sh_size); ++i) {
+      const Elf64_Sym& sym = syms[i];
+      if (ELF64_ST_TYPE(sym.st_info) != STT_FUNC || sym.st_value == 0 ||
+          sym.st_name >= strings.sh_size) {
+        continue;
+      }
+      const char* name = reinterpret_cast<const char*>(data + strings.sh_offset + sym.st_name);
+      symbols_.push_back({sym.st_value, sym.st_size, Demangle(name)});
+    }
+  }
+  ::munmap(mapped, size);
+
+  std::sort(symbols_.begin(), symbols_.end(),
+            [](const Symbol& a, const Symbol& b) { return a.start < b.start; });
+  return true;
+}
+
+bool ElfSymbolizer::FileOffsetToVaddr(std::uint64_t offset, std::uint64_t& vaddr) const {
+  for (const LoadSegment& segment : segments_) {
+    if (offset >= segment.offset && offset - segment.offset < segment.file_size) {
+      vaddr = segment.vaddr + (offset - segment.offset);
+      return true;
+    }
+  }
+  return false;
+}
+
+std::string ElfSymbolizer::Lookup(std::uint64_t vaddr, std::uint64_t* name_offset) const {
+  auto it = std::upper_bound(symbols_.begin(), symbols_.end(), vaddr,
+                             [](std::uint64_t value, const Symbol& s) { return value < s.start; });
+  if (it == symbols_.begin()) {
+    return std::string();
+  }
+  --it;
+  // 大小为 0 的符号（_init/_fini 之类）不认：它们会把后面整片非代码区域都吞进去。
+  if (vaddr - it->start >= it->size) {
+    return std::string();
+  }
+  if (name_offset != nullptr) {
+    *name_offset = vaddr - it->start;
+  }
+  return it->name;
+}
@@ -0,0 +1,45 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// 在一段 ELF note 里找 NT_GNU_BUILD_ID，返回十六进制串；没有时返回空串。
+std::string FindGnuBuildId(const unsigned char* notes, std::uint64_t size);
+
+/*
+ * 离线符号化：读取 ELF 文件的 .symtab（剥离后退回 .dynsym）里的函数符号，
+ * 按地址排序后二分查找。用于在崩溃进程之外把 minidump / core 里的地址还原成函数名。
+ */
+class ElfSymbolizer final {
+ public:
+  bool Load(const std::string& path, std::string& error);
+
+  // 把文件偏移换算成 ELF 虚拟地址（按 PT_LOAD 段）；不在任何段内时返回 false。
+  bool FileOffsetToVaddr(std::uint64_t offset, std::uint64_t& vaddr) const;
+
+  // vaddr 是 ELF 内的虚拟地址；找不到时返回空串。name_offset 为地址相对函数起点的偏移。
+  std::string Lookup(std::uint64_t vaddr, std::uint64_t* name_offset = nullptr) const;
+
+  std::size_t symbol_count() const { return symbols_.size(); }
+
+  // 文件 PT_NOTE 里的 GNU build-id（十六进制）；链接时没有生成则为空。
+  const std::string& build_id() const { return build_id_; }
+
+ private:
+  struct Symbol {
+    std::uint64_t start;
+    std::uint64_t size;
+    std::string name;
+  };
+
+  struct LoadSegment {
+    std::uint64_t offset;
+    std::uint64_t vaddr;
+    std::uint64_t file_size;
+  };
+
+  std::vector<Symbol> symbols_;
+  std::vector<LoadSegment> segments_;
+  std::string build_id_;
+};
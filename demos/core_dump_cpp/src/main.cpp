@@ -1,10 +1,205 @@
 #include "A.h"
 #include "B.h"
+#include "async_log.h"
 
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
 #include <iostream>
+#include <string>
 
-int main() {
-  std::cout << "Create B as A*, then delete it to trigger virtual destructor chain." << std::endl;
+#if defined(CORE_DUMP_HAVE_CRASH_REPORTER)
+#include "crash_reporter.h"
+
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#endif
+
+#if defined(CORE_DUMP_HAVE_DUMP_ARENA)
+#include "dump_arena.h"
+#endif
+
+namespace {
+
+struct Options {
+  std::string mode = "kernel";
+  std::string dump_path = "core_dump_demo.mdmp";
+  // 崩溃前分配并写满的大块数据（MiB），模拟大堆进程。
+  long heap_mb = 0;
+  // 大块数据放进 MADV_DONTDUMP 的 arena，而不是普通堆。
+  bool heap_dontdump = false;
+  // 启动时写入 /proc/self/coredump_filter；-1 表示不修改。
+  long coredump_filter = -1;
+};
+
+bool ParseOptions(int argc, char** argv, Options& options) {
+  int positional = 0;
+  for (int i = 1; i < argc; ++i) {
+    const std::string arg = argv[i];
+    if (arg == "--heap-mb" && i + 1 < argc) {
+      char* end = nullptr;
+      options.heap_mb = std::strtol(argv[++i], &end, 10);
+      if (*end != '\0' || options.heap_mb < 0) {
+        return false;
+      }
+    } else if (arg == "--heap-dontdump") {
+      options.heap_dontdump = true;
+    } else if (arg == "--coredump-filter" && i + 1 < argc) {
+      char* end = nullptr;
+      options.coredump_filter = std::strtol(argv[++i], &end, 0);
+      if (*end != '\0' || options.coredump_filter < 0 || options.coredump_filter > 0x1ff) {
+        return false;
+      }
+    } else if (arg.compare(0, 2, "--") == 0) {
+      return false;
+    } else if (positional == 0) {
+      options.mode = arg;
+      ++positional;
+    } else if (positional == 1 && options.mode == "minidump") {
+      options.dump_path = arg;
+      ++positional;
+    } else {
+      return false;
+    }
+  }
+  return options.mode == "kernel" || options.mode == "minidump";
+}
+
+#if defined(CORE_DUMP_HAVE_CRASH_REPORTER)
+constexpr int kParkedWorkers = 2;
+
+std::mutex g_park_mu;
+std::condition_variable g_park_cv;
+int g_parked = 0;
+
+// 一直阻塞的工作线程：让 minidump 里有崩溃线程之外的线程栈可看。
+void ParkedWorker(int id) {
+  std::unique_lock<std::mutex> lock(g_park_mu);
+  async_log::LogLine() << "[worker " << id << "] parked";
+  ++g_parked;
+  g_park_cv.notify_all();
+  g_park_cv.wait(lock, [] { return false; });
+}
+
+bool StartMinidumpMode(const std::string& dump_path) {
+  crash_report::CrashReporterOptions options;
+  options.dump_path = dump_path;
+  std::string error;
+  if (!crash_report::CrashReporter::Instance().Install(options, error)) {
+    std::cerr << "crash reporter: " << error << '\n';
+    return false;
+  }
+  async_log::LogLine() << "[main] crash reporter installed, minidump -> " << dump_path;
+
+  for (int i = 0; i < kParkedWorkers; ++i) {
+    std::thread(ParkedWorker, i).detach();
+  }
+  std::unique_lock<std::mutex> lock(g_park_mu);
+  g_park_cv.wait(lock, [] { return g_parked == kParkedWorkers; });
+  return true;
+}
+#endif
+
+// 日志写线程放行崩溃信号与 crash reporter 的抓取信号：崩溃线程逐个 tgkill 抓现场时它也会响应，
+// minidump 不用等到超时。
+async_log::LoggerOptions MakeLoggerOptions() {
+  async_log::LoggerOptions options;
+  options.deliverable_signals = {SIGSEGV, SIGBUS, SIGABRT, SIGFPE, SIGILL};
+#if defined(CORE_DUMP_HAVE_CRASH_REPORTER)
+  options.deliverable_signals.push_back(crash_report::CrashReporter::CaptureSignal());
+#endif
+  return options;
+}
+
+#if defined(CORE_DUMP_HAVE_DUMP_ARENA)
+DumpArena g_bulk_arena;
+#endif
+
+// 故意不释放：崩溃时这块数据仍然驻留，core 的大小主要由它决定。
+bool AllocateBulkData(const Options& options) {
+  const std::size_t bytes = static_cast<std::size_t>(options.heap_mb) << 20;
+  unsigned char* data = nullptr;
+  if (options.heap_dontdump) {
+#if defined(CORE_DUMP_HAVE_DUMP_ARENA)
+    std::string error;
+    if (!g_bulk_arena.Init(bytes, DumpPolicy::kExclude, error)) {
+      std::cerr << "bulk arena: " << error << '\n';
+      return false;
+    }
+    data = static_cast<unsigned char*>(g_bulk_arena.Allocate(bytes));
+#else
+    std::cerr << "--heap-dontdump is only built on Linux\n";
+    return false;
+#endif
+  } else {
+    data = new unsigned char[bytes];
+  }
+  // 非零填充保证每一页都真实分配。
+  std::memset(data, 0x5a, bytes);
+  async_log::LogLine() << "[main] bulk data: " << options.heap_mb << " MiB in "
+                       << (options.heap_dontdump ? "arena (MADV_DONTDUMP)" : "heap");
+  return true;
+}
+
+bool ApplyCoredumpFilter(long mask) {
+#if defined(CORE_DUMP_HAVE_DUMP_ARENA)
+  std::string error;
+  unsigned previous = 0;
+  if (!ReadCoredumpFilter(previous, error) ||
+      !SetCoredumpFilter(static_cast<unsigned>(mask), error)) {
+    std::cerr << "coredump_filter: " << error << '\n';
+    return false;
+  }
+  async_log::LogLine() << "[main] coredump_filter " << async_log::Hex{previous} << " -> "
+                       << async_log::Hex{static_cast<std::uint64_t>(mask)};
+  return true;
+#else
+  (void)mask;
+  std::cerr << "--coredump-filter is only built on Linux\n";
+  return false;
+#endif
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  Options options;
+  if (!ParseOptions(argc, argv, options)) {
+    std::cerr << "usage: " << argv[0]
+              << " [kernel | minidump [dump_path]] [--heap-mb N] [--heap-dontdump]"
+                 " [--coredump-filter MASK]\n";
+    return 2;
+  }
+
+  // 日志交给后台线程批量写出；启动失败时 LogLine 退回同步 write，demo 照常运行。
+  std::string error;
+  if (!async_log::Logger::Instance().Start(MakeLoggerOptions(), error)) {
+    std::cerr << "async_log: " << error << '\n';
+  }
+
+  if (options.coredump_filter >= 0 && !ApplyCoredumpFilter(options.coredump_filter)) {
+    return 1;
+  }
+  if (options.mode == "minidump") {
+#if defined(CORE_DUMP_HAVE_CRASH_REPORTER)
+    if (!StartMinidumpMode(options.dump_path)) {
+      return 1;
+    }
+#else
+    std::cerr << "minidump mode is only built on Linux\n";
+    return 1;
+#endif
+  }
+  if (options.heap_mb > 0 && !AllocateBulkData(options)) {
+    return 1;
+  }
+  // 在 crash reporter 之后安装：崩溃时先写出日志，再交给 reporter 写 minidump。
+  if (!async_log::Logger::Instance().InstallCrashFlush(error)) {
+    std::cerr << "async_log: " << error << '\n';
+  }
+
+  async_log::LogLine() << "Create B as A*, then delete it to trigger virtual destructor chain.";
   A* obj = new B();
   delete obj;
   return 0;
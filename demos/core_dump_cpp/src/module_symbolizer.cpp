@@ -0,0 +1,133 @@
+#include "module_symbolizer.h"
+
+#include <algorithm>
+#include <sstream>
+
+namespace {
+
+std::string BaseName(const std::string& path) {
+  const std::size_t slash = path.rfind('/');
+  return slash == std::string::npos ? path : path.substr(slash + 1);
+}
+
+}  // namespace
+
+std::vector<ModuleMapping> ParseProcMaps(const std::string& text) {
+  std::vector<ModuleMapping> maps;
+  std::istringstream in(text);
+  std::string line;
+  while (std::getline(in, line)) {
+    // 格式：start-end perms offset dev inode [path]
+    std::istringstream fields(line);
+    std::string range;
+    std::string perms;
+    std::string offset;
+    std::string dev;
+    std::string inode;
+    ModuleMapping mapping;
+    if (!(fields >> range >> perms >> offset >> dev >> inode)) {
+      continue;
+    }
+    const std::size_t dash = range.find('-');
+    if (dash == std::string::npos) {
+      continue;
+    }
+    mapping.start = std::stoull(range.substr(0, dash), nullptr, 16);
+    mapping.end = std::stoull(range.substr(dash + 1), nullptr, 16);
+    mapping.offset = std::stoull(offset, nullptr, 16);
+    mapping.executable = perms.size() >= 3 && perms[2] == 'x';
+    std::getline(fields >> std::ws, mapping.path);
+    maps.push_back(std::move(mapping));
+  }
+  return maps;
+}
+
+const ModuleMapping* ModuleSymbolizer::Find(std::uint64_t address) const {
+  // 两种来源的映射表都按起始地址升序且互不重叠。
+  auto it = std::upper_bound(
+      maps_.begin(), maps_.end(), address,
+      [](std::uint64_t value, const ModuleMapping& mapping) { return value < mapping.start; });
+  if (it == maps_.begin()) {
+    return nullptr;
+  }
+  --it;
+  return address < it->end ? &*it : nullptr;
+}
+
+bool ModuleSymbolizer::IsCode(std::uint64_t address) const {
+  const ModuleMapping* mapping = Find(address);
+  return mapping != nullptr && mapping->executable && !mapping->path.empty() &&
+         mapping->path[0] == '/';
+}
+
+ModuleSymbolizer::Resolved ModuleSymbolizer::Resolve(std::uint64_t address) {
+  Resolved resolved;
+  resolved.mapping = Find(address);
+  if (resolved.mapping == nullptr || resolved.mapping->path.empty() ||
+      resolved.mapping->path[0] != '/') {
+    return resolved;
+  }
+  resolved.file_offset = address - resolved.mapping->start + resolved.mapping->offset;
+  std::uint64_t vaddr = 0;
+  const ElfSymbolizer* elf = Load(resolved.mapping->path);
+  if (verify_build_id_ && (elf == nullptr || resolved.mapping->build_id.empty() ||
+                           elf->build_id() != resolved.mapping->build_id)) {
+    resolved.verified = false;
+    return resolved;
+  }
+  if (elf != nullptr && elf->FileOffsetToVaddr(resolved.file_offset, vaddr)) {
+    resolved.function = elf->Lookup(vaddr, &resolved.function_offset);
+  }
+  return resolved;
+}
+
+bool ModuleSymbolizer::IsFunctionAddress(std::uint64_t address) {
+  return !Resolve(address).function.empty();
+}
+
+std::string ModuleSymbolizer::Describe(std::uint64_t address) {
+  const Resolved resolved = Resolve(address);
+  if (resolved.mapping == nullptr || resolved.mapping->path.empty() ||
+      resolved.mapping->path[0] != '/') {
+    return resolved.mapping != nullptr && !resolved.mapping->path.empty()
+               ? resolved.mapping->path
+               : "??";
+  }
+  std::ostringstream out;
+  if (!resolved.function.empty()) {
+    out << resolved.function << "+0x" << std::hex << resolved.function_offset << ' ';
+  }
+  out << '(' << BaseName(resolved.mapping->path) << "+0x" << std::hex << resolved.file_offset
+      << ')';
+  return out.str();
+}
+
+std::string ModuleSymbolizer::StableName(std::uint64_t address, bool* verified) {
+  const Resolved resolved = Resolve(address);
+  if (verified != nullptr) {
+    *verified = resolved.verified;
+  }
+  if (resolved.mapping == nullptr || resolved.mapping->path.empty()) {
+    return "??";
+  }
+  const std::string module = BaseName(resolved.mapping->path);
+  if (!resolved.function.empty()) {
+    return module + "!" + resolved.function;
+  }
+  std::ostringstream out;
+  out << module << "+0x" << std::hex << resolved.file_offset;
+  return out.str();
+}
+
+const ElfSymbolizer* ModuleSymbolizer::Load(const std::string& path) {
+  auto it = cache_.find(path);
+  if (it == cache_.end()) {
+    auto symbolizer = std::make_unique<ElfSymbolizer>();
+    std::string error;
+    if (!symbolizer->Load(path, error)) {
+      symbolizer.reset();
+    }
+    it = cache_.emplace(path, std::move(symbolizer)).first;
+  }
+  return it->second.get();
+}
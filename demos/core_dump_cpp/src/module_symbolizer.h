@@ -0,0 +1,71 @@
+#pragma once
+
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "elf_symbolizer.h"
+
+// 崩溃进程里的一段映射：来自 minidump 里的 /proc/self/maps 文本，或 core 的 NT_FILE note。
+struct ModuleMapping {
+  std::uint64_t start = 0;
+  std::uint64_t end = 0;
+  // 映射起点对应的文件偏移（字节）。
+  std::uint64_t offset = 0;
+  bool executable = false;
+  std::string path;
+  // 崩溃时模块的 GNU build-id（十六进制）；core 的 ELF 头页里读不到时为空。
+  std::string build_id;
+};
+
+std::vector<ModuleMapping> ParseProcMaps(const std::string& text);
+
+/*
+ * 按映射表把崩溃进程里的地址还原成“函数+偏移 (模块+文件偏移)”。
+ * 模块的 ELF 符号表按路径缓存，只在第一次用到时读取；非线程安全，每个线程各用一个。
+ */
+class ModuleSymbolizer final {
+ public:
+  ModuleSymbolizer() = default;
+  explicit ModuleSymbolizer(std::vector<ModuleMapping> maps) : maps_(std::move(maps)) {}
+
+  // 换一份映射表（例如处理下一个 core），保留已加载的符号表缓存。
+  void Reset(std::vector<ModuleMapping> maps) { maps_ = std::move(maps); }
+
+  // 开启后，只有映射里的 build-id 与磁盘上文件的一致时才查符号；
+  // 不一致或任一方缺失时按“模块+文件偏移”给出，避免拿换过版本的二进制给出错误的函数名。
+  void set_verify_build_id(bool verify) { verify_build_id_ = verify; }
+
+  const ModuleMapping* Find(std::uint64_t address) const;
+
+  // 地址落在有路径的可执行映射里。
+  bool IsCode(std::uint64_t address) const;
+
+  // 地址落在某个模块的函数符号范围内；映射表没有权限信息（如 NT_FILE）时代替 IsCode 使用。
+  bool IsFunctionAddress(std::uint64_t address);
+
+  // 例：B::~B()+0xbd (core_dump_demo+0x4c8f)
+  std::string Describe(std::uint64_t address);
+
+  // 与加载地址无关的短名字，用于给调用栈分组：有符号时是 "模块!函数"，否则 "模块+文件偏移"。
+  // verified 非空时写入：符号是否来自 build-id 核对过的文件（未开启核对时恒为 true）。
+  std::string StableName(std::uint64_t address, bool* verified = nullptr);
+
+ private:
+  struct Resolved {
+    const ModuleMapping* mapping = nullptr;
+    std::uint64_t file_offset = 0;
+    std::string function;
+    std::uint64_t function_offset = 0;
+    bool verified = true;
+  };
+
+  Resolved Resolve(std::uint64_t address);
+  const ElfSymbolizer* Load(const std::string& path);
+
+  std::vector<ModuleMapping> maps_;
+  std::map<std::string, std::unique_ptr<ElfSymbolizer>> cache_;
+  bool verify_build_id_ = false;
+};
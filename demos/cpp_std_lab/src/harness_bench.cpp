@@ -0,0 +1,97 @@
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+#ifdef __has_include
+#if __has_include(<version>)
+#include <version>
+#endif
+#if __has_include(<ranges>)
+#include <ranges>
+#endif
+#endif
+
+#include "bench_harness.h"
+
+#ifndef DEMO_STD
+#define DEMO_STD 0
+#endif
+
+#if defined(__cplusplus) && (__cplusplus >= 202002L) && defined(__cpp_lib_ranges) && (__cpp_lib_ranges >= 201911L)
+#define CPP_STD_LAB_HAS_RANGES 1
+#else
+#define CPP_STD_LAB_HAS_RANGES 0
+#endif
+
+namespace {
+
+std::vector<int> make_input(std::size_t n) {
+  std::mt19937 rng(12345);
+  std::uniform_int_distribution<int> dist(-1000000, 1000000);
+  std::vector<int> data(n);
+  for (int& value : data) {
+    value = dist(rng);
+  }
+  return data;
+}
+
+// 每次迭代都从同一份乱序输入复制一份再选择；copy 基线给出复制本身的开销。
+void register_size(bench::Suite& suite, std::size_t n) {
+  const std::string suffix = "/n=" + std::to_string(n);
+  const auto input = std::make_shared<const std::vector<int>>(make_input(n));
+  const std::size_t k = n / 2;
+
+  suite.Add("copy" + suffix, [input](bench::State& state) {
+    std::vector<int> data;
+    for (std::uint64_t i = 0; i < state.iterations(); ++i) {
+      data = *input;
+      bench::DoNotOptimize(data.data());
+      bench::ClobberMemory();
+    }
+  });
+
+  suite.Add("std::nth_element" + suffix, [input, k](bench::State& state) {
+    std::vector<int> data;
+    for (std::uint64_t i = 0; i < state.iterations(); ++i) {
+      data = *input;
+      const auto nth = data.end() - static_cast<std::ptrdiff_t>(k);
+      std::nth_element(data.begin(), nth, data.end());
+      bench::DoNotOptimize(*nth);
+    }
+  });
+
+#if CPP_STD_LAB_HAS_RANGES
+  suite.Add("std::ranges::nth_element" + suffix, [input, k](bench::State& state) {
+    std::vector<int> data;
+    for (std::uint64_t i = 0; i < state.iterations(); ++i) {
+      data = *input;
+      const auto nth = data.end() - static_cast<std::ptrdiff_t>(k);
+      std::ranges::nth_element(data, nth);
+      bench::DoNotOptimize(*nth);
+    }
+  });
+#endif
+
+  // 参照：完整排序后取第 k 大，体现 nth_element 省下的部分。
+  suite.Add("std::sort" + suffix, [input, k](bench::State& state) {
+    std::vector<int> data;
+    for (std::uint64_t i = 0; i < state.iterations(); ++i) {
+      data = *input;
+      std::sort(data.begin(), data.end());
+      bench::DoNotOptimize(data[data.size() - k]);
+    }
+  });
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  bench::Suite suite("cpp_std_lab_cpp" + std::to_string(DEMO_STD));
+  register_size(suite, 1000);
+  register_size(suite, 100000);
+  return suite.Run(argc, argv);
+}
@@ -1,7 +1,11 @@
 #pragma once
 
+#include <cstddef>
 #include <cstdint>
 
+// 插件 ABI 版本：DemoSnapshot 布局或导出函数签名变化时递增，宿主加载时校验。
+constexpr std::uint32_t kDemoApiVersion = 2;
+
 struct DemoSnapshot {
   const char* lib_name;
 
@@ -27,7 +31,32 @@ struct DemoSnapshot {
   std::uintptr_t unique_fn_addr;
 };
 
+// 批量接口的输出（structure of arrays）：每个逐项变化的字段一个数组，长度 >= count，由调用方分配。
+// 与逐项无关的字段（变量值、地址）不必每项重复，需要时调用一次 *_snapshot 即可。
+struct DemoBatchOutput {
+  int* shared_fn_result;
+  int* unique_fn_result;
+};
+
+// 插件对宿主的接口显式标成 default 可见性：-fvisibility=hidden 的构建变体里只导出这些。
+#define DEMO_EXPORT __attribute__((visibility("default")))
+
 extern "C" {
-DemoSnapshot demo_one_snapshot(int x);
-DemoSnapshot demo_two_snapshot(int x);
+DEMO_EXPORT DemoSnapshot demo_one_snapshot(int x);
+DEMO_EXPORT DemoSnapshot demo_two_snapshot(int x);
+DEMO_EXPORT std::uint32_t demo_one_api_version();
+DEMO_EXPORT std::uint32_t demo_two_api_version();
+// 重新解析库内缓存的 RTLD_DEFAULT 查找（g_shared_value / shared_compute），snapshot 的 default_* 字段
+// 用的就是这份缓存。加载集合变化后调用；plugin_loader 通过 PluginSpec::bind_symbol 自动完成。
+DEMO_EXPORT void demo_one_bind_defaults();
+DEMO_EXPORT void demo_two_bind_defaults();
+// demo_one 的构建编号（-DDEMO_ONE_BUILD=N），热替换时用来区分新旧版本。
+DEMO_EXPORT std::uint32_t demo_one_build_id();
+// 批量版 snapshot：对 xs[0..count) 逐项计算，结果与逐项调用 *_snapshot 的对应字段一致。
+// 一次跨 so 调用处理整批输入，库内是可向量化的紧凑循环。
+DEMO_EXPORT void demo_one_snapshot_batch(const int* xs, std::size_t count, DemoBatchOutput* out);
+DEMO_EXPORT void demo_two_snapshot_batch(const int* xs, std::size_t count, DemoBatchOutput* out);
+// 在库内部连续调用 iterations 次 shared_compute，供 variant_bench 测量库内调用的成本。
+DEMO_EXPORT std::int64_t demo_one_bench_shared_compute(std::uint64_t iterations);
+DEMO_EXPORT std::int64_t demo_two_bench_shared_compute(std::uint64_t iterations);
 }
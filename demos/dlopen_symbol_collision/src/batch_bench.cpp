@@ -0,0 +1,145 @@
+#include "demo_plugin.h"
+
+#include <dlfcn.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <filesystem>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+constexpr std::size_t kBatchSizes[] = {1, 16, 256, 4096};
+constexpr std::size_t kInputCount = 4096;
+constexpr int kRepeats = 3;
+
+struct SoaBuffers {
+  std::vector<int> shared_fn_result;
+  std::vector<int> unique_fn_result;
+
+  explicit SoaBuffers(std::size_t n) : shared_fn_result(n), unique_fn_result(n) {}
+
+  DemoBatchOutput View(std::size_t offset) {
+    return DemoBatchOutput{shared_fn_result.data() + offset, unique_fn_result.data() + offset};
+  }
+};
+
+template <typename Body>
+double BestItemsPerSecond(std::uint64_t items, Body body) {
+  double best = 0;
+  for (int r = 0; r < kRepeats; ++r) {
+    const auto begin = Clock::now();
+    body();
+    const std::chrono::duration<double> elapsed = Clock::now() - begin;
+    best = std::max(best, static_cast<double>(items) / elapsed.count());
+  }
+  return best;
+}
+
+// 逐项调用：每个输入一次跨 so 调用，按值返回整个 DemoSnapshot。
+double PerItemRate(const DemoBatchTable& table, const std::vector<int>& xs, SoaBuffers& out,
+                   std::uint64_t total) {
+  return BestItemsPerSecond(total, [&]() {
+    for (std::uint64_t i = 0; i < total; ++i) {
+      const std::size_t slot = i % kInputCount;
+      const DemoSnapshot snap = table.snapshot(xs[slot]);
+      out.shared_fn_result[slot] = snap.shared_fn_result;
+      out.unique_fn_result[slot] = snap.unique_fn_result;
+    }
+  });
+}
+
+double BatchRate(const DemoBatchTable& table, const std::vector<int>& xs, SoaBuffers& out,
+                 std::uint64_t total, std::size_t batch) {
+  const std::uint64_t calls = total / batch;
+  return BestItemsPerSecond(calls * batch, [&]() {
+    for (std::uint64_t c = 0; c < calls; ++c) {
+      const std::size_t offset = (c * batch) % kInputCount;
+      DemoBatchOutput view = out.View(offset);
+      table.snapshot_batch(xs.data() + offset, batch, &view);
+    }
+  });
+}
+
+// 批量结果必须与逐项调用的对应字段完全一致（包括被抢占时的行为）。
+bool BatchMatchesPerItem(const DemoBatchTable& table, const std::vector<int>& xs) {
+  SoaBuffers batch(kInputCount);
+  DemoBatchOutput view = batch.View(0);
+  table.snapshot_batch(xs.data(), kInputCount, &view);
+  for (std::size_t i = 0; i < kInputCount; ++i) {
+    const DemoSnapshot snap = table.snapshot(xs[i]);
+    if (snap.shared_fn_result != batch.shared_fn_result[i] ||
+        snap.unique_fn_result != batch.unique_fn_result[i]) {
+      return false;
+    }
+  }
+  return true;
+}
+
+void PrintRow(const std::string& name, double rate, double baseline) {
+  std::cout << std::left << std::setw(34) << name << std::right << std::fixed
+            << std::setprecision(1) << std::setw(12) << rate / 1e6 << std::setw(9)
+            << rate / baseline << "x\n";
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  const std::uint64_t total = argc >= 2 ? std::strtoull(argv[1], nullptr, 10) : (1u << 24);
+  if (total < kInputCount) {
+    std::cerr << "usage: " << argv[0] << " [items>=" << kInputCount << "]\n";
+    return 2;
+  }
+
+  // 用 -O2 的 default 变体：-O0 的 demo_one/demo_two 不会向量化，比较没有意义。
+  const std::filesystem::path dir =
+      std::filesystem::canonical(std::filesystem::path(argv[0])).parent_path() / "variants" /
+      "default";
+  Plugin<DemoBatchTable> one;
+  Plugin<DemoBatchTable> two;
+  std::string error;
+  // 与 dlopen_symbol_demo 12 相同的顺序：demo_two 的 shared_compute 会被 demo_one 抢占。
+  if (!one.Open((dir / (std::string(DEMO_LIB_PREFIX) + "demo_one" + DEMO_LIB_SUFFIX)).string(),
+                RTLD_NOW | RTLD_GLOBAL, kDemoOneBatchSpec, &error) ||
+      !two.Open((dir / (std::string(DEMO_LIB_PREFIX) + "demo_two" + DEMO_LIB_SUFFIX)).string(),
+                RTLD_NOW | RTLD_GLOBAL, kDemoTwoBatchSpec, &error)) {
+    std::cerr << error << '\n';
+    return 1;
+  }
+
+  std::vector<int> xs(kInputCount);
+  std::uint32_t state = 12345;
+  for (int& x : xs) {
+    state = state * 1664525u + 1013904223u;
+    x = static_cast<int>(state >> 24);
+  }
+  SoaBuffers out(kInputCount);
+
+  std::cout << "== per-item snapshot vs batched SoA entry point ==\n"
+            << total << " items per measurement, best of " << kRepeats
+            << ", libraries from variants/default (-O2)\n\n"
+            << std::left << std::setw(34) << "MODE" << std::right << std::setw(12)
+            << "Mitems/s" << std::setw(10) << "vs item" << '\n';
+
+  const double per_item = PerItemRate(*one, xs, out, total);
+  PrintRow("demo_one per-item snapshot", per_item, per_item);
+  for (const std::size_t batch : kBatchSizes) {
+    PrintRow("demo_one batch " + std::to_string(batch), BatchRate(*one, xs, out, total, batch),
+             per_item);
+  }
+  const double two_item = PerItemRate(*two, xs, out, total);
+  PrintRow("demo_two per-item (interposed)", two_item, two_item);
+  PrintRow("demo_two batch 4096 (interposed)", BatchRate(*two, xs, out, total, 4096), two_item);
+
+  std::cout << "\nbatch == per-item results: demo_one "
+            << (BatchMatchesPerItem(*one, xs) ? "YES" : "NO") << ", demo_two "
+            << (BatchMatchesPerItem(*two, xs) ? "YES" : "NO") << '\n';
+  return 0;
+}
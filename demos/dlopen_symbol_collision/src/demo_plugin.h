@@ -0,0 +1,109 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <string>
+
+#include "api.h"
+#include "plugin_loader.h"
+
+// 宿主需要从 demo_one / demo_two 拿到的全部符号，加载时一次性解析。
+struct DemoPluginTable {
+  DemoSnapshot (*snapshot)(int);
+  // 通过库句柄解析同名符号，拿到的是该库自己的定义（不受全局抢占影响）。
+  int (*shared_compute)(int);
+  int (*shared_touch)();
+  int* shared_value;
+};
+
+// 在 RTLD_DEFAULT 里解析的同名符号：结果是全局搜索顺序里的第一个定义。
+struct DefaultSymbolTable {
+  int* shared_value;
+  int (*shared_compute)(int);
+  int (*shared_touch)();
+};
+
+inline constexpr SymbolSpec kDemoOneSymbols[] = {
+    {"demo_one_snapshot", offsetof(DemoPluginTable, snapshot)},
+    {"shared_compute", offsetof(DemoPluginTable, shared_compute)},
+    {"shared_touch", offsetof(DemoPluginTable, shared_touch)},
+    {"g_shared_value", offsetof(DemoPluginTable, shared_value)},
+};
+
+inline constexpr SymbolSpec kDemoTwoSymbols[] = {
+    {"demo_two_snapshot", offsetof(DemoPluginTable, snapshot)},
+    {"shared_compute", offsetof(DemoPluginTable, shared_compute)},
+    {"shared_touch", offsetof(DemoPluginTable, shared_touch)},
+    {"g_shared_value", offsetof(DemoPluginTable, shared_value)},
+};
+
+inline constexpr PluginSpec kDemoOneSpec = {
+    "demo_one_api_version", kDemoApiVersion, kDemoOneSymbols,
+    sizeof(kDemoOneSymbols) / sizeof(kDemoOneSymbols[0]),
+    "demo_one_bind_defaults"};
+
+inline constexpr PluginSpec kDemoTwoSpec = {
+    "demo_two_api_version", kDemoApiVersion, kDemoTwoSymbols,
+    sizeof(kDemoTwoSymbols) / sizeof(kDemoTwoSymbols[0]),
+    "demo_two_bind_defaults"};
+
+inline constexpr SymbolSpec kDefaultSymbols[] = {
+    {"g_shared_value", offsetof(DefaultSymbolTable, shared_value)},
+    {"shared_compute", offsetof(DefaultSymbolTable, shared_compute)},
+    {"shared_touch", offsetof(DefaultSymbolTable, shared_touch)},
+};
+
+// 热替换 demo_one 时使用的函数表。
+struct DemoOneReloadTable {
+  std::uint32_t (*build_id)();
+  int (*shared_compute)(int);
+  DemoSnapshot (*snapshot)(int);
+};
+
+inline constexpr SymbolSpec kDemoOneReloadSymbols[] = {
+    {"demo_one_build_id", offsetof(DemoOneReloadTable, build_id)},
+    {"shared_compute", offsetof(DemoOneReloadTable, shared_compute)},
+    {"demo_one_snapshot", offsetof(DemoOneReloadTable, snapshot)},
+};
+
+inline constexpr PluginSpec kDemoOneReloadSpec = {
+    "demo_one_api_version", kDemoApiVersion, kDemoOneReloadSymbols,
+    sizeof(kDemoOneReloadSymbols) / sizeof(kDemoOneReloadSymbols[0]),
+    "demo_one_bind_defaults"};
+
+// 热替换用的第 generation 代 demo_one：奇数代是 demo_one，偶数代是 demo_one_v2，
+// 复制到 <build_dir>/reload/ 下的独立文件，返回其路径（失败返回空串）。
+inline std::string StageDemoOneGeneration(const std::filesystem::path& build_dir,
+                                          std::uint64_t generation, std::string* error) {
+  const char* name = generation % 2 == 1 ? "demo_one" : "demo_one_v2";
+  const std::filesystem::path source =
+      build_dir / (std::string(DEMO_LIB_PREFIX) + name + DEMO_LIB_SUFFIX);
+  return StagePluginCopy(source.string(), (build_dir / "reload").string(), generation, error);
+}
+
+// 批量接口对比用的函数表：逐项 snapshot 与批量 snapshot_batch。
+struct DemoBatchTable {
+  DemoSnapshot (*snapshot)(int);
+  void (*snapshot_batch)(const int*, std::size_t, DemoBatchOutput*);
+};
+
+inline constexpr SymbolSpec kDemoOneBatchSymbols[] = {
+    {"demo_one_snapshot", offsetof(DemoBatchTable, snapshot)},
+    {"demo_one_snapshot_batch", offsetof(DemoBatchTable, snapshot_batch)},
+};
+
+inline constexpr SymbolSpec kDemoTwoBatchSymbols[] = {
+    {"demo_two_snapshot", offsetof(DemoBatchTable, snapshot)},
+    {"demo_two_snapshot_batch", offsetof(DemoBatchTable, snapshot_batch)},
+};
+
+inline constexpr PluginSpec kDemoOneBatchSpec = {
+    "demo_one_api_version", kDemoApiVersion, kDemoOneBatchSymbols,
+    sizeof(kDemoOneBatchSymbols) / sizeof(kDemoOneBatchSymbols[0]),
+    "demo_one_bind_defaults"};
+
+inline constexpr PluginSpec kDemoTwoBatchSpec = {
+    "demo_two_api_version", kDemoApiVersion, kDemoTwoBatchSymbols,
+    sizeof(kDemoTwoBatchSymbols) / sizeof(kDemoTwoBatchSymbols[0]),
+    "demo_two_bind_defaults"};
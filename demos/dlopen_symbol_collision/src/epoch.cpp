@@ -0,0 +1,18 @@
+#include "epoch.h"
+
+int EpochDomain::RegisterReader() {
+  const int slot = registered_.fetch_add(1, std::memory_order_relaxed);
+  return slot < kMaxReaders ? slot : -1;
+}
+
+bool EpochDomain::Quiescent(std::uint64_t retire_epoch) const {
+  const int registered = registered_.load(std::memory_order_acquire);
+  const int count = registered < kMaxReaders ? registered : kMaxReaders;
+  for (int i = 0; i < count; ++i) {
+    const std::uint64_t epoch = slots_[i].epoch.load(std::memory_order_seq_cst);
+    if (epoch != 0 && epoch < retire_epoch) {
+      return false;
+    }
+  }
+  return true;
+}
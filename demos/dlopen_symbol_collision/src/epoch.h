@@ -0,0 +1,47 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+
+/*
+ * 基于 epoch 的回收（EBR）：
+ * - 读者进入临界区时把当前全局 epoch 记到自己的槽位，离开时清零；读者从不加锁、不等待。
+ * - 写者替换指针后推进全局 epoch 得到 retire_epoch；旧对象只有在所有槽位
+ *   要么为 0、要么 >= retire_epoch 时才可以释放（此后不可能再有读者持有旧指针）。
+ *
+ * 读者槽位数量固定，每个读者线程先 RegisterReader() 拿到自己的槽位。
+ */
+class EpochDomain final {
+ public:
+  static constexpr int kMaxReaders = 64;
+
+  // 返回槽位下标，槽位用完时返回 -1。
+  int RegisterReader();
+
+  void Enter(int slot) {
+    // seq_cst store：保证后续读取被保护指针时，写者一定能看到本槽位的 epoch。
+    slots_[slot].epoch.store(epoch_.load(std::memory_order_seq_cst), std::memory_order_seq_cst);
+  }
+
+  void Exit(int slot) {
+    slots_[slot].epoch.store(0, std::memory_order_release);
+  }
+
+  // 写者在发布新指针之后调用，返回旧对象的 retire_epoch。
+  std::uint64_t Advance() {
+    return epoch_.fetch_add(1, std::memory_order_seq_cst) + 1;
+  }
+
+  // 是否已没有读者可能持有 retire_epoch 之前发布的指针。
+  bool Quiescent(std::uint64_t retire_epoch) const;
+
+ private:
+  struct alignas(64) Slot {
+    std::atomic<std::uint64_t> epoch{0};
+  };
+
+  // 从 1 开始：槽位值 0 表示“不在临界区”。
+  std::atomic<std::uint64_t> epoch_{1};
+  std::atomic<int> registered_{0};
+  Slot slots_[kMaxReaders];
+};
@@ -0,0 +1,131 @@
+#include "demo_plugin.h"
+
+#include <dlfcn.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <filesystem>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "bench_harness.h"
+
+namespace {
+
+constexpr std::size_t kInputCount = 4096;
+constexpr std::size_t kBatch = 256;
+
+std::string LibPath(const std::filesystem::path& dir, const char* name) {
+  return (dir / (std::string(DEMO_LIB_PREFIX) + name + DEMO_LIB_SUFFIX)).string();
+}
+
+}  // namespace
+
+/*
+ * dlopen_symbol_collision 各热路径的统一格式 benchmark：
+ * - 逐次 dlsym 与缓存函数表的调用成本（与 dlopen_resolve_bench 相同的对比）；
+ * - 逐项 snapshot 与批量 SoA 接口的每项成本（与 dlopen_batch_bench 相同的对比）；
+ * - 一次性解析符号表、以及 dlopen + dlclose 一个未加载库的延迟。
+ * demo_one / demo_two 用 variants/default 下的 -O2 版本，加载顺序与 dlopen_symbol_demo 相同。
+ */
+int main(int argc, char** argv) {
+  const std::filesystem::path build_dir =
+      std::filesystem::canonical(std::filesystem::path(argv[0])).parent_path();
+  const std::filesystem::path variant_dir = build_dir / "variants" / "default";
+
+  Plugin<DemoPluginTable> one;
+  Plugin<DemoPluginTable> two;
+  Plugin<DemoBatchTable> one_batch;
+  std::string error;
+  if (!one.Open(LibPath(variant_dir, "demo_one"), RTLD_NOW | RTLD_GLOBAL, kDemoOneSpec, &error) ||
+      !two.Open(LibPath(variant_dir, "demo_two"), RTLD_NOW | RTLD_GLOBAL, kDemoTwoSpec, &error) ||
+      !one_batch.Open(LibPath(variant_dir, "demo_one"), RTLD_NOW | RTLD_GLOBAL,
+                      kDemoOneBatchSpec, &error)) {
+    std::cerr << error << '\n';
+    return 1;
+  }
+
+  std::vector<int> xs(kInputCount);
+  std::uint32_t seed = 12345;
+  for (int& x : xs) {
+    seed = seed * 1664525u + 1013904223u;
+    x = static_cast<int>(seed >> 24);
+  }
+  std::vector<int> shared_out(kInputCount);
+  std::vector<int> unique_out(kInputCount);
+
+  void* two_handle = two.handle();
+  const DemoPluginTable& two_table = *two;
+  const DemoBatchTable& batch_table = *one_batch;
+
+  bench::Suite suite("dlopen_symbol_collision");
+  suite.Add("shared_compute/dlsym_per_call", [two_handle](bench::State& state) {
+    int acc = 0;
+    for (std::uint64_t i = 0; i < state.iterations(); ++i) {
+      auto fn = reinterpret_cast<int (*)(int)>(dlsym(two_handle, "shared_compute"));
+      acc += fn(static_cast<int>(i & 0xff));
+    }
+    bench::DoNotOptimize(acc);
+  });
+  suite.Add("shared_compute/rtld_default_dlsym", [](bench::State& state) {
+    int acc = 0;
+    for (std::uint64_t i = 0; i < state.iterations(); ++i) {
+      auto fn = reinterpret_cast<int (*)(int)>(dlsym(RTLD_DEFAULT, "shared_compute"));
+      acc += fn(static_cast<int>(i & 0xff));
+    }
+    bench::DoNotOptimize(acc);
+  });
+  suite.Add("shared_compute/cached_table", [&two_table](bench::State& state) {
+    int acc = 0;
+    for (std::uint64_t i = 0; i < state.iterations(); ++i) {
+      acc += two_table.shared_compute(static_cast<int>(i & 0xff));
+    }
+    bench::DoNotOptimize(acc);
+  });
+
+  // 每项一次跨 so 调用，按值返回整个 DemoSnapshot。
+  suite.Add("snapshot/per_item", [&](bench::State& state) {
+    for (std::uint64_t i = 0; i < state.iterations(); ++i) {
+      const std::size_t slot = i % kInputCount;
+      const DemoSnapshot snap = batch_table.snapshot(xs[slot]);
+      shared_out[slot] = snap.shared_fn_result;
+      unique_out[slot] = snap.unique_fn_result;
+    }
+    bench::ClobberMemory();
+  });
+  // 同样的项数，按 kBatch 项一批调用批量接口；ns/op 仍是每项。
+  suite.Add("snapshot/batch_256", [&](bench::State& state) {
+    std::size_t offset = 0;
+    for (std::uint64_t done = 0; done < state.iterations();) {
+      const std::size_t n =
+          static_cast<std::size_t>(std::min<std::uint64_t>(kBatch, state.iterations() - done));
+      DemoBatchOutput view{shared_out.data() + offset, unique_out.data() + offset};
+      batch_table.snapshot_batch(xs.data() + offset, n, &view);
+      done += n;
+      offset = (offset + kBatch) % kInputCount;
+    }
+    bench::ClobberMemory();
+  });
+
+  suite.AddLatency("resolve_symbol_table/4_symbols", [two_handle] {
+    DemoPluginTable table{};
+    std::string resolve_error;
+    bool ok = ResolveSymbolTable(two_handle, kDemoTwoSymbols,
+                                 sizeof(kDemoTwoSymbols) / sizeof(kDemoTwoSymbols[0]), &table,
+                                 sizeof(table), &resolve_error);
+    bench::DoNotOptimize(ok);
+  });
+
+  // demo_one_v2 不在进程里，每次 dlopen 都要真正映射、重定位，dlclose 再卸载。
+  const std::string v2_path = LibPath(build_dir, "demo_one_v2");
+  suite.AddLatency("dlopen+dlclose/demo_one_v2", [&v2_path] {
+    void* handle = dlopen(v2_path.c_str(), RTLD_NOW | RTLD_LOCAL);
+    bench::DoNotOptimize(handle);
+    if (handle != nullptr) {
+      dlclose(handle);
+    }
+  });
+
+  return suite.Run(argc, argv);
+}
@@ -0,0 +1,134 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "epoch.h"
+#include "plugin_loader.h"
+
+/*
+ * 可热替换的插件：新版本与旧版本同时加载，函数表通过一次原子指针交换发布。
+ * - 调用方：ReadGuard 进入 epoch 临界区后读取当前函数表，全程无锁、不会被 Reload 阻塞。
+ * - Reload：加载新版本 -> exchange 指针 -> 推进 epoch -> 旧版本进入待回收列表。
+ * - ReclaimRetired：对已没有调用方在用的旧版本执行 dlclose。
+ *
+ * 同一路径重复 dlopen 只会增加引用计数，宿主需要为每次 Reload 提供不同的文件
+ * （例如把新版本复制到带代号的文件名），才能让新旧版本真正并存。
+ */
+template <typename Table>
+class HotSwapPlugin final {
+ public:
+  struct Generation {
+    void* handle;
+    Table table;
+    std::uint64_t id;
+  };
+
+  class ReadGuard final {
+   public:
+    ReadGuard(HotSwapPlugin& plugin, int slot)
+        : domain_(plugin.epochs_), slot_(slot) {
+      domain_.Enter(slot_);
+      generation_ = plugin.current_.load(std::memory_order_seq_cst);
+    }
+
+    ~ReadGuard() {
+      domain_.Exit(slot_);
+    }
+
+    ReadGuard(const ReadGuard&) = delete;
+    ReadGuard& operator=(const ReadGuard&) = delete;
+
+    // 尚未加载任何版本时为 nullptr。
+    const Generation* generation() const {
+      return generation_;
+    }
+
+    const Table* operator->() const {
+      return &generation_->table;
+    }
+
+   private:
+    EpochDomain& domain_;
+    int slot_;
+    const Generation* generation_ = nullptr;
+  };
+
+  HotSwapPlugin() = default;
+  HotSwapPlugin(const HotSwapPlugin&) = delete;
+  HotSwapPlugin& operator=(const HotSwapPlugin&) = delete;
+
+  // 析构时要求已没有调用方。
+  ~HotSwapPlugin() {
+    std::lock_guard<std::mutex> lock(writer_mu_);
+    for (auto& retired : retired_) {
+      Destroy(retired.generation);
+    }
+    Destroy(current_.load(std::memory_order_relaxed));
+  }
+
+  int RegisterReader() {
+    return epochs_.RegisterReader();
+  }
+
+  bool Reload(const std::string& path, int flags, const PluginSpec& spec, std::string* error) {
+    std::lock_guard<std::mutex> lock(writer_mu_);
+    auto generation = std::make_unique<Generation>();
+    generation->handle =
+        OpenPlugin(path, flags, spec, &generation->table, sizeof(Table), error);
+    if (generation->handle == nullptr) {
+      return false;
+    }
+    generation->id = ++next_id_;
+
+    Generation* old = current_.exchange(generation.release(), std::memory_order_seq_cst);
+    if (old != nullptr) {
+      retired_.push_back({old, epochs_.Advance()});
+    }
+    return true;
+  }
+
+  // 回收所有已无调用方的旧版本，返回本次 dlclose 的个数。
+  int ReclaimRetired() {
+    std::lock_guard<std::mutex> lock(writer_mu_);
+    int reclaimed = 0;
+    for (auto it = retired_.begin(); it != retired_.end();) {
+      if (epochs_.Quiescent(it->retire_epoch)) {
+        Destroy(it->generation);
+        it = retired_.erase(it);
+        ++reclaimed;
+      } else {
+        ++it;
+      }
+    }
+    return reclaimed;
+  }
+
+  std::size_t RetiredCount() {
+    std::lock_guard<std::mutex> lock(writer_mu_);
+    return retired_.size();
+  }
+
+ private:
+  struct Retired {
+    Generation* generation;
+    std::uint64_t retire_epoch;
+  };
+
+  static void Destroy(Generation* generation) {
+    if (generation != nullptr) {
+      ClosePlugin(generation->handle);
+      delete generation;
+    }
+  }
+
+  EpochDomain epochs_;
+  std::atomic<Generation*> current_{nullptr};
+  std::mutex writer_mu_;
+  std::vector<Retired> retired_;
+  std::uint64_t next_id_ = 0;
+};
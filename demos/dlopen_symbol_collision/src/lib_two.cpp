@@ -2,15 +2,65 @@
 
 #include <dlfcn.h>
 
+#include <atomic>
+
+namespace {
+
+struct DefaultSymbols {
+  int* shared_var;
+  int (*shared_fn)(int);
+};
+
+DefaultSymbols ResolveDefaultSymbols() {
+  DefaultSymbols symbols{};
+  symbols.shared_var = reinterpret_cast<int*>(dlsym(RTLD_DEFAULT, "g_shared_value"));
+  symbols.shared_fn =
+      reinterpret_cast<int (*)(int)>(dlsym(RTLD_DEFAULT, "shared_compute"));
+  return symbols;
+}
+
+// RTLD_DEFAULT 的查找结果取决于当前加载了哪些库，由宿主在加载集合变化后调用
+// demo_two_bind_defaults() 刷新（plugin_loader 每次加载、卸载插件后都会调用）。
+// 从未绑定过（宿主没有经 plugin_loader 加载）时退回逐次查找。
+std::atomic<bool> g_defaults_bound{false};
+std::atomic<int*> g_default_shared_var{nullptr};
+std::atomic<int (*)(int)> g_default_shared_fn{nullptr};
+
+DefaultSymbols CurrentDefaultSymbols() {
+  if (!g_defaults_bound.load(std::memory_order_acquire)) {
+    return ResolveDefaultSymbols();
+  }
+  DefaultSymbols symbols{};
+  symbols.shared_var = g_default_shared_var.load(std::memory_order_relaxed);
+  symbols.shared_fn = g_default_shared_fn.load(std::memory_order_relaxed);
+  return symbols;
+}
+
+// shared_compute 的函数体：逐项调用与批量路径共用，保证两边的结果一致。
+inline int SharedComputeBody(int shared_value, int x) {
+  return shared_value + x + 2;
+}
+
+}  // namespace
+
 extern "C" {
 
 int g_shared_value = 222;
 int g_shared_counter = 2000;
 
-int shared_compute(int x) {
-  return g_shared_value + x + 2;
+// noinline：保证各构建变体比较的是“调用方式”（PLT / GOT / 直接调用），而不是内联与否。
+__attribute__((noinline)) int shared_compute(int x) {
+  return SharedComputeBody(g_shared_value, x);
 }
 
+// 本库 shared_compute 的隐藏别名：与 &shared_compute（可能被其他库抢占）比较，判断是否被抢占。
+// alias 只有 ELF 支持（Mach-O 没有），copy 属性只有 GCC 支持；其他平台不定义别名，批量接口逐项调用。
+#if defined(__ELF__) && defined(__GNUC__) && !defined(__clang__)
+#define DEMO_HAVE_LOCAL_ALIAS 1
+int shared_compute_local(int x)
+    __attribute__((alias("shared_compute"), visibility("hidden"), copy(shared_compute)));
+#endif
+
 int shared_touch() {
   return ++g_shared_counter;
 }
@@ -21,6 +71,54 @@ int unique_compute_two(int x) {
   return g_unique_two + x;
 }
 
+std::uint32_t demo_two_api_version() {
+  return kDemoApiVersion;
+}
+
+void demo_two_bind_defaults() {
+  const DefaultSymbols symbols = ResolveDefaultSymbols();
+  g_default_shared_var.store(symbols.shared_var, std::memory_order_relaxed);
+  g_default_shared_fn.store(symbols.shared_fn, std::memory_order_relaxed);
+  g_defaults_bound.store(true, std::memory_order_release);
+}
+
+std::int64_t demo_two_bench_shared_compute(std::uint64_t iterations) {
+  std::int64_t acc = 0;
+  for (std::uint64_t i = 0; i < iterations; ++i) {
+    acc += shared_compute(static_cast<int>(acc & 0xff));
+  }
+  return acc;
+}
+
+void demo_two_snapshot_batch(const int* xs, std::size_t count, DemoBatchOutput* out) {
+  const int* __restrict in = xs;
+  int* __restrict shared_out = out->shared_fn_result;
+  int* __restrict unique_out = out->unique_fn_result;
+  // 全局变量每批只读一次（仍经 GOT，变量被抢占时读到的与逐项调用一致）。
+  const int shared_value = g_shared_value;
+  const int unique_value = g_unique_two;
+
+  bool not_interposed = false;
+#if defined(DEMO_HAVE_LOCAL_ALIAS)
+  not_interposed = &shared_compute == &shared_compute_local;
+#endif
+  if (not_interposed) {
+    // 函数未被抢占：把 shared_compute 展开成可向量化的循环。
+    for (std::size_t i = 0; i < count; ++i) {
+      shared_out[i] = SharedComputeBody(shared_value, in[i]);
+    }
+  } else {
+    // 函数被其他库抢占：保持与逐项调用相同的语义，逐个调用抢占后的实现。
+    int (*const compute)(int) = &shared_compute;
+    for (std::size_t i = 0; i < count; ++i) {
+      shared_out[i] = compute(in[i]);
+    }
+  }
+  for (std::size_t i = 0; i < count; ++i) {
+    unique_out[i] = unique_value + in[i];
+  }
+}
+
 DemoSnapshot demo_two_snapshot(int x) {
   DemoSnapshot snap{};
   snap.lib_name = "demo_two";
@@ -34,10 +132,9 @@ DemoSnapshot demo_two_snapshot(int x) {
   snap.shared_touch_result = shared_touch();
   snap.shared_touch_addr = reinterpret_cast<std::uintptr_t>(&shared_touch);
 
-  auto* default_shared_var = reinterpret_cast<int*>(
-      dlsym(RTLD_DEFAULT, "g_shared_value"));
-  auto* default_shared_fn = reinterpret_cast<int (*)(int)>(
-      dlsym(RTLD_DEFAULT, "shared_compute"));
+  const DefaultSymbols defaults = CurrentDefaultSymbols();
+  int* default_shared_var = defaults.shared_var;
+  int (*default_shared_fn)(int) = defaults.shared_fn;
 
   snap.default_shared_var_value =
       (default_shared_var != nullptr) ? *default_shared_var : -1;
@@ -0,0 +1,241 @@
+#include <dlfcn.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+// glibc 最多 16 个链接命名空间（DL_NNS），其中一个是主程序自己的。
+constexpr int kMaxNewNamespaces = 15;
+constexpr int kParallelThreads[] = {2, 4, 8};
+
+enum class LoadApi {
+  kDlopen,
+  // 所有库加载到同一个新命名空间：第一个库会把 libc/libstdc++ 再加载一份。
+  kDlmopenShared,
+  // 每个库一个新命名空间：隔离最彻底，但受 kMaxNewNamespaces 限制。
+  kDlmopenPerLib,
+};
+
+struct LoadMode {
+  const char* name;
+  LoadApi api;
+  int flags;
+  int threads;
+};
+
+struct CellResult {
+  bool ok = false;
+  int libs = 0;
+  double total_ms = 0;
+  double avg_us = 0;
+  double max_us = 0;
+  double first_call_ms = 0;
+  std::int64_t checksum = 0;
+  char error[160] = {};
+};
+
+struct LoadContext {
+  std::filesystem::path dir;
+  int lib_count = 0;
+};
+
+std::string LibPath(const LoadContext& ctx, int index) {
+  return (ctx.dir / (std::string(DEMO_LIB_PREFIX) + "synth_" + std::to_string(index) +
+                     DEMO_LIB_SUFFIX))
+      .string();
+}
+
+double ElapsedUs(Clock::time_point begin) {
+  return std::chrono::duration<double, std::micro>(Clock::now() - begin).count();
+}
+
+void Fail(CellResult& result, const char* what) {
+  const char* err = dlerror();
+  std::snprintf(result.error, sizeof(result.error), "%s: %s", what, err ? err : "null");
+}
+
+/*
+ * 加载 [0, libs) 中 index % stride == offset 的库，把句柄和单库耗时写进对应下标。
+ * 并行模式下每个线程负责一个 offset。
+ */
+bool LoadSlice(const LoadContext& ctx, const LoadMode& mode, int libs, int offset, int stride,
+               std::vector<void*>& handles, std::vector<double>& load_us, CellResult& result) {
+  Lmid_t shared_ns = LM_ID_NEWLM;
+  for (int i = offset; i < libs; i += stride) {
+    const std::string path = LibPath(ctx, i);
+    const auto begin = Clock::now();
+    void* handle = nullptr;
+    if (mode.api == LoadApi::kDlopen) {
+      handle = dlopen(path.c_str(), mode.flags);
+    } else if (mode.api == LoadApi::kDlmopenShared) {
+      handle = dlmopen(shared_ns, path.c_str(), mode.flags);
+      if (handle != nullptr && shared_ns == LM_ID_NEWLM &&
+          dlinfo(handle, RTLD_DI_LMID, &shared_ns) != 0) {
+        Fail(result, "dlinfo");
+        return false;
+      }
+    } else {
+      handle = dlmopen(LM_ID_NEWLM, path.c_str(), mode.flags);
+    }
+    load_us[i] = ElapsedUs(begin);
+    if (handle == nullptr) {
+      Fail(result, path.c_str());
+      return false;
+    }
+    handles[i] = handle;
+  }
+  return true;
+}
+
+CellResult RunCell(const LoadContext& ctx, const LoadMode& mode) {
+  CellResult result;
+  const int libs = mode.api == LoadApi::kDlmopenPerLib
+                       ? std::min(ctx.lib_count, kMaxNewNamespaces)
+                       : ctx.lib_count;
+  std::vector<void*> handles(libs, nullptr);
+  std::vector<double> load_us(libs, 0);
+
+  const auto begin = Clock::now();
+  if (mode.threads <= 1) {
+    if (!LoadSlice(ctx, mode, libs, 0, 1, handles, load_us, result)) {
+      return result;
+    }
+  } else {
+    std::vector<std::thread> threads;
+    std::vector<CellResult> slices(mode.threads);
+    std::vector<char> slice_ok(mode.threads, 0);
+    for (int t = 0; t < mode.threads; ++t) {
+      threads.emplace_back([&, t]() {
+        slice_ok[t] = LoadSlice(ctx, mode, libs, t, mode.threads, handles, load_us, slices[t]);
+      });
+    }
+    for (auto& thread : threads) {
+      thread.join();
+    }
+    for (int t = 0; t < mode.threads; ++t) {
+      if (!slice_ok[t]) {
+        return slices[t];
+      }
+    }
+  }
+  result.total_ms = ElapsedUs(begin) / 1e3;
+
+  // 首次调用每个库的 entry：LAZY 模式推迟的 PLT 解析成本会在这里付出。
+  const auto call_begin = Clock::now();
+  for (int i = 0; i < libs; ++i) {
+    const std::string entry = "synth_" + std::to_string(i) + "_entry";
+    auto* fn = reinterpret_cast<int (*)(int)>(dlsym(handles[i], entry.c_str()));
+    if (fn == nullptr) {
+      Fail(result, entry.c_str());
+      return result;
+    }
+    result.checksum += fn(1);
+  }
+  result.first_call_ms = ElapsedUs(call_begin) / 1e3;
+
+  double sum_us = 0;
+  for (const double us : load_us) {
+    sum_us += us;
+    result.max_us = std::max(result.max_us, us);
+  }
+  result.libs = libs;
+  result.avg_us = sum_us / libs;
+  result.ok = true;
+  return result;
+}
+
+// 每个模式在独立子进程里跑：已加载的库无法真正卸载干净，不能在同一进程里比较。
+bool RunCellInChild(const LoadContext& ctx, const LoadMode& mode, CellResult& result) {
+  int fds[2];
+  if (::pipe(fds) != 0) {
+    return false;
+  }
+  std::cout.flush();
+  const pid_t pid = ::fork();
+  if (pid == 0) {
+    ::close(fds[0]);
+    const CellResult child = RunCell(ctx, mode);
+    const ssize_t written = ::write(fds[1], &child, sizeof(child));
+    ::_exit(written == static_cast<ssize_t>(sizeof(child)) ? 0 : 1);
+  }
+  ::close(fds[1]);
+  const bool ok =
+      pid > 0 && ::read(fds[0], &result, sizeof(result)) == static_cast<ssize_t>(sizeof(result));
+  ::close(fds[0]);
+  if (pid > 0) {
+    ::waitpid(pid, nullptr, 0);
+  }
+  return ok;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  LoadContext ctx;
+  ctx.lib_count = argc >= 2 ? std::atoi(argv[1]) : DEMO_SYNTH_LIB_COUNT;
+  if (ctx.lib_count <= 0 || ctx.lib_count > DEMO_SYNTH_LIB_COUNT) {
+    std::cerr << "usage: " << argv[0] << " [libs]   (1.." << DEMO_SYNTH_LIB_COUNT
+              << ", rebuild with -DDEMO_SYNTH_LIB_COUNT=N for more)\n";
+    return 2;
+  }
+  ctx.dir = std::filesystem::canonical(std::filesystem::path(argv[0])).parent_path() / "synth";
+
+  std::vector<LoadMode> modes = {
+      {"dlopen NOW|GLOBAL", LoadApi::kDlopen, RTLD_NOW | RTLD_GLOBAL, 1},
+      {"dlopen NOW|LOCAL", LoadApi::kDlopen, RTLD_NOW | RTLD_LOCAL, 1},
+      {"dlopen LAZY|GLOBAL", LoadApi::kDlopen, RTLD_LAZY | RTLD_GLOBAL, 1},
+      {"dlopen LAZY|LOCAL", LoadApi::kDlopen, RTLD_LAZY | RTLD_LOCAL, 1},
+      {"dlmopen shared ns NOW", LoadApi::kDlmopenShared, RTLD_NOW | RTLD_LOCAL, 1},
+      {"dlmopen ns/lib NOW", LoadApi::kDlmopenPerLib, RTLD_NOW | RTLD_LOCAL, 1},
+  };
+  const std::vector<std::string> parallel_names = {"parallel x2 NOW|LOCAL",
+                                                   "parallel x4 NOW|LOCAL",
+                                                   "parallel x8 NOW|LOCAL"};
+  for (std::size_t i = 0; i < parallel_names.size(); ++i) {
+    modes.push_back({parallel_names[i].c_str(), LoadApi::kDlopen, RTLD_NOW | RTLD_LOCAL,
+                     kParallelThreads[i]});
+  }
+
+  std::cout << "== dlopen cost for " << ctx.lib_count << " synthetic libraries ==\n"
+            << "dir: " << ctx.dir.string() << "\n"
+            << "dlmopen ns/lib is capped at " << kMaxNewNamespaces
+            << " libraries (glibc namespace limit)\n\n"
+            << std::left << std::setw(24) << "MODE" << std::right << std::setw(6) << "LIBS"
+            << std::setw(11) << "TOTAL ms" << std::setw(12) << "AVG us/lib" << std::setw(11)
+            << "MAX us" << std::setw(15) << "1st CALLS ms" << std::setw(12) << "CHECKSUM"
+            << '\n';
+
+  for (const LoadMode& mode : modes) {
+    CellResult result;
+    if (!RunCellInChild(ctx, mode, result)) {
+      std::cerr << "benchmark child failed for " << mode.name << '\n';
+      return 1;
+    }
+    std::cout << std::left << std::setw(24) << mode.name << std::right;
+    if (!result.ok) {
+      std::cout << "  error: " << result.error << '\n';
+      continue;
+    }
+    std::cout << std::setw(6) << result.libs << std::fixed << std::setprecision(2)
+              << std::setw(11) << result.total_ms << std::setprecision(1) << std::setw(12)
+              << result.avg_us << std::setw(11) << result.max_us << std::setprecision(2)
+              << std::setw(15) << result.first_call_ms << std::setw(12) << result.checksum
+              << '\n';
+  }
+  return 0;
+}
@@ -1,7 +1,9 @@
-#include "api.h"
+#include "demo_plugin.h"
+#include "hot_swap_plugin.h"
 
 #include <dlfcn.h>
 
+#include <cstdint>
 #include <filesystem>
 #include <iomanip>
 #include <iostream>
@@ -11,32 +13,18 @@
 
 namespace {
 
-using SnapshotFn = DemoSnapshot (*)(int);
-using SharedComputeFn = int (*)(int);
-using SharedTouchFn = int (*)();
-
-void* MustLoadSymbol(void* handle, const char* symbol_name) {
-  dlerror();
-  void* symbol = dlsym(handle, symbol_name);
-  const char* err = dlerror();
-  if (err != nullptr || symbol == nullptr) {
-    std::cerr << "dlsym failed for symbol '" << symbol_name << "': "
-              << (err ? err : "null") << '\n';
-    std::exit(1);
-  }
-  return symbol;
-}
+struct PluginEntry {
+  std::string file_name;
+  const PluginSpec* spec;
+};
 
-void* MustLoadLibrary(const std::filesystem::path& lib_path) {
-  dlerror();
-  void* handle = dlopen(lib_path.c_str(), RTLD_NOW | RTLD_GLOBAL);
-  const char* err = dlerror();
-  if (err != nullptr || handle == nullptr) {
-    std::cerr << "dlopen failed for " << lib_path << ": "
-              << (err ? err : "null") << '\n';
+void MustOpenPlugin(Plugin<DemoPluginTable>& plugin, const std::filesystem::path& lib_path,
+                    const PluginSpec& spec) {
+  std::string error;
+  if (!plugin.Open(lib_path.string(), RTLD_NOW | RTLD_GLOBAL, spec, &error)) {
+    std::cerr << error << '\n';
     std::exit(1);
   }
-  return handle;
 }
 
 std::string HexAddr(std::uintptr_t addr) {
@@ -63,12 +51,67 @@ void PrintSnapshot(const DemoSnapshot& snap) {
             << ", addr=" << HexAddr(snap.unique_fn_addr) << '\n';
 }
 
+using DemoOneHotSwap = HotSwapPlugin<DemoOneReloadTable>;
+
+bool ReloadDemoOne(DemoOneHotSwap& plugin, const std::filesystem::path& build_dir,
+                   std::uint64_t generation) {
+  std::string error;
+  const std::string staged = StageDemoOneGeneration(build_dir, generation, &error);
+  const bool ok = !staged.empty() &&
+                  plugin.Reload(staged, RTLD_NOW | RTLD_LOCAL, kDemoOneReloadSpec, &error);
+  if (!staged.empty()) {
+    // 映射建立后文件即可删除，句柄在 dlclose 之前一直有效。
+    std::filesystem::remove(staged);
+  }
+  if (!ok) {
+    std::cerr << error << '\n';
+  }
+  return ok;
+}
+
+int DemoHotReload(const std::filesystem::path& build_dir) {
+  DemoOneHotSwap plugin;
+  const int slot = plugin.RegisterReader();
+
+  std::cout << "[hot reload demo_one]\n";
+  for (std::uint64_t generation = 1; generation <= 3; ++generation) {
+    if (!ReloadDemoOne(plugin, build_dir, generation)) {
+      return 1;
+    }
+    {
+      DemoOneHotSwap::ReadGuard guard(plugin, slot);
+      std::cout << "  generation " << guard.generation()->id
+                << ": build_id=" << guard->build_id()
+                << ", shared_compute(7)=" << guard->shared_compute(7) << '\n';
+    }
+    std::cout << "  reclaimed old versions: " << plugin.ReclaimRetired() << '\n';
+  }
+
+  // 调用方还在使用旧版本时发生替换：旧版本必须保留到调用方离开临界区。
+  std::cout << "\n[reload while a caller is in flight]\n";
+  {
+    DemoOneHotSwap::ReadGuard in_flight(plugin, slot);
+    if (!ReloadDemoOne(plugin, build_dir, 4)) {
+      return 1;
+    }
+    std::cout << "  reclaimed while in flight : " << plugin.ReclaimRetired()
+              << " (pending " << plugin.RetiredCount() << ")\n"
+              << "  in-flight caller still on : build_id=" << in_flight->build_id() << '\n';
+  }
+  std::cout << "  reclaimed after it left   : " << plugin.ReclaimRetired() << '\n';
+  {
+    DemoOneHotSwap::ReadGuard guard(plugin, slot);
+    std::cout << "  new callers see           : build_id=" << guard->build_id() << '\n';
+  }
+  return 0;
+}
+
 }  // namespace
 
 int main(int argc, char** argv) {
   const std::string order = (argc >= 2) ? argv[1] : "12";
-  if (order != "12" && order != "21") {
-    std::cerr << "Usage: " << argv[0] << " [12|21]\n";
+  if (order != "12" && order != "21" && order != "reload") {
+    std::cerr << "Usage: " << argv[0] << " [12|21|reload]\n";
     return 1;
   }
 
@@ -76,57 +119,70 @@ int main(int argc, char** argv) {
       std::filesystem::canonical(std::filesystem::path(argv[0]));
   const std::filesystem::path build_dir = exe_path.parent_path();
 
-  const std::string lib1_name =
-      std::string(DEMO_LIB_PREFIX) + "demo_one" + DEMO_LIB_SUFFIX;
-  const std::string lib2_name =
-      std::string(DEMO_LIB_PREFIX) + "demo_two" + DEMO_LIB_SUFFIX;
+  if (order == "reload") {
+    return DemoHotReload(build_dir);
+  }
 
-  std::vector<std::string> load_seq =
-      (order == "12") ? std::vector<std::string>{lib1_name, lib2_name}
-                      : std::vector<std::string>{lib2_name, lib1_name};
+  const PluginEntry one{std::string(DEMO_LIB_PREFIX) + "demo_one" + DEMO_LIB_SUFFIX,
+                        &kDemoOneSpec};
+  const PluginEntry two{std::string(DEMO_LIB_PREFIX) + "demo_two" + DEMO_LIB_SUFFIX,
+                        &kDemoTwoSpec};
 
-  std::cout << "Load order: " << load_seq[0] << " -> " << load_seq[1] << "\n\n";
+  std::vector<PluginEntry> load_seq =
+      (order == "12") ? std::vector<PluginEntry>{one, two}
+                      : std::vector<PluginEntry>{two, one};
 
-  void* handle_first = MustLoadLibrary(build_dir / load_seq[0]);
-  void* handle_second = MustLoadLibrary(build_dir / load_seq[1]);
+  std::cout << "Load order: " << load_seq[0].file_name << " -> " << load_seq[1].file_name
+            << "\n\n";
 
-  auto* one_fn = reinterpret_cast<SnapshotFn>(
-      MustLoadSymbol(handle_first, (order == "12") ? "demo_one_snapshot"
-                                                    : "demo_two_snapshot"));
-  auto* two_fn = reinterpret_cast<SnapshotFn>(
-      MustLoadSymbol(handle_second, (order == "12") ? "demo_two_snapshot"
-                                                     : "demo_one_snapshot"));
+  // 每个插件加载时一次性解析符号表（含 ABI 版本检查），之后只走缓存的函数指针。
+  // 析构顺序与声明相反：先关闭后加载的插件。
+  Plugin<DemoPluginTable> first_plugin;
+  Plugin<DemoPluginTable> second_plugin;
+  MustOpenPlugin(first_plugin, build_dir / load_seq[0].file_name, *load_seq[0].spec);
+  MustOpenPlugin(second_plugin, build_dir / load_seq[1].file_name, *load_seq[1].spec);
 
   const int x = 7;
-  DemoSnapshot first = one_fn(x);
-  DemoSnapshot second = two_fn(x);
+  DemoSnapshot first = first_plugin->snapshot(x);
+  DemoSnapshot second = second_plugin->snapshot(x);
 
   PrintSnapshot(first);
   std::cout << '\n';
   PrintSnapshot(second);
   std::cout << '\n';
 
-  auto* default_shared_var = reinterpret_cast<int*>(
-      MustLoadSymbol(RTLD_DEFAULT, "g_shared_value"));
-  auto* default_shared_compute = reinterpret_cast<SharedComputeFn>(
-      MustLoadSymbol(RTLD_DEFAULT, "shared_compute"));
-  auto* default_shared_touch = reinterpret_cast<SharedTouchFn>(
-      MustLoadSymbol(RTLD_DEFAULT, "shared_touch"));
+  std::cout << "[plugin tables (per-handle dlsym, resolved once)]\n";
+  const Plugin<DemoPluginTable>* plugins[] = {&first_plugin, &second_plugin};
+  for (int i = 0; i < 2; ++i) {
+    const DemoPluginTable& table = **plugins[i];
+    std::cout << "  " << load_seq[i].file_name << ": shared_compute(" << x
+              << ")=" << table.shared_compute(x) << ", addr="
+              << HexAddr(reinterpret_cast<std::uintptr_t>(table.shared_compute))
+              << ", g_shared_value=" << *table.shared_value << '\n';
+  }
+  std::cout << '\n';
+
+  DefaultSymbolTable defaults{};
+  std::string error;
+  if (!ResolveSymbolTable(RTLD_DEFAULT, kDefaultSymbols,
+                          sizeof(kDefaultSymbols) / sizeof(kDefaultSymbols[0]), &defaults,
+                          sizeof(defaults), &error)) {
+    std::cerr << error << '\n';
+    return 1;
+  }
 
   std::cout << "[RTLD_DEFAULT]\n"
-            << "  g_shared_value=" << *default_shared_var
-            << ", addr=" << HexAddr(reinterpret_cast<std::uintptr_t>(default_shared_var))
+            << "  g_shared_value=" << *defaults.shared_value
+            << ", addr=" << HexAddr(reinterpret_cast<std::uintptr_t>(defaults.shared_value))
             << '\n'
-            << "  shared_compute(" << x << ")=" << default_shared_compute(x)
+            << "  shared_compute(" << x << ")=" << defaults.shared_compute(x)
             << ", addr="
-            << HexAddr(reinterpret_cast<std::uintptr_t>(default_shared_compute))
+            << HexAddr(reinterpret_cast<std::uintptr_t>(defaults.shared_compute))
             << '\n'
-            << "  shared_touch()=" << default_shared_touch()
+            << "  shared_touch()=" << defaults.shared_touch()
             << ", addr="
-            << HexAddr(reinterpret_cast<std::uintptr_t>(default_shared_touch))
+            << HexAddr(reinterpret_cast<std::uintptr_t>(defaults.shared_touch))
             << '\n';
 
-  dlclose(handle_second);
-  dlclose(handle_first);
   return 0;
 }
@@ -0,0 +1,142 @@
+#include "plugin_loader.h"
+
+#include <dlfcn.h>
+
+#include <cstring>
+#include <filesystem>
+#include <mutex>
+#include <system_error>
+#include <vector>
+
+namespace {
+
+void SetError(std::string* error, const std::string& message) {
+  if (error != nullptr) {
+    *error = message;
+  }
+}
+
+struct BoundPlugin {
+  void* handle;
+  void (*bind)();
+};
+
+std::mutex g_bind_mu;
+// 经本加载器打开、带绑定函数的插件；同一句柄被打开几次就有几项。
+std::vector<BoundPlugin> g_bound;
+
+// 加载集合刚变化：让每个已加载插件重新解析它缓存的全局查找。调用方持有 g_bind_mu。
+void RebindAllLocked() {
+  for (const BoundPlugin& plugin : g_bound) {
+    plugin.bind();
+  }
+}
+
+}  // namespace
+
+bool ResolveSymbolTable(void* handle, const SymbolSpec* symbols, std::size_t count, void* table,
+                        std::size_t table_size, std::string* error) {
+  auto* base = static_cast<unsigned char*>(table);
+  for (std::size_t i = 0; i < count; ++i) {
+    const SymbolSpec& spec = symbols[i];
+    if (spec.offset + sizeof(void*) > table_size) {
+      SetError(error, std::string("symbol '") + spec.name + "' is outside the table");
+      return false;
+    }
+
+    dlerror();
+    void* symbol = dlsym(handle, spec.name);
+    const char* err = dlerror();
+    if (err != nullptr || symbol == nullptr) {
+      SetError(error, std::string("dlsym failed for symbol '") + spec.name +
+                          "': " + (err ? err : "null"));
+      return false;
+    }
+    // POSIX 保证函数指针与 void* 可以互相转换，这里按字节写入槽位。
+    std::memcpy(base + spec.offset, &symbol, sizeof(symbol));
+  }
+  return true;
+}
+
+void* OpenPlugin(const std::string& path, int flags, const PluginSpec& spec, void* table,
+                 std::size_t table_size, std::string* error) {
+  dlerror();
+  void* handle = dlopen(path.c_str(), flags);
+  const char* err = dlerror();
+  if (err != nullptr || handle == nullptr) {
+    SetError(error, "dlopen failed for " + path + ": " + (err ? err : "null"));
+    return nullptr;
+  }
+
+  // ABI 版本在解析其余符号之前检查：版本不对时符号表的签名也不可信。
+  dlerror();
+  auto* abi_fn = reinterpret_cast<std::uint32_t (*)()>(dlsym(handle, spec.abi_symbol));
+  err = dlerror();
+  if (err != nullptr || abi_fn == nullptr) {
+    SetError(error, std::string("missing ABI symbol '") + spec.abi_symbol + "' in " + path);
+    dlclose(handle);
+    return nullptr;
+  }
+  const std::uint32_t abi = abi_fn();
+  if (abi != spec.expected_abi) {
+    SetError(error, path + ": ABI version " + std::to_string(abi) + ", expected " +
+                        std::to_string(spec.expected_abi));
+    dlclose(handle);
+    return nullptr;
+  }
+
+  if (!ResolveSymbolTable(handle, spec.symbols, spec.symbol_count, table, table_size, error)) {
+    dlclose(handle);
+    return nullptr;
+  }
+
+  void (*bind)() = nullptr;
+  if (spec.bind_symbol != nullptr) {
+    dlerror();
+    bind = reinterpret_cast<void (*)()>(dlsym(handle, spec.bind_symbol));
+    err = dlerror();
+    if (err != nullptr || bind == nullptr) {
+      SetError(error, std::string("missing bind symbol '") + spec.bind_symbol + "' in " + path);
+      dlclose(handle);
+      return nullptr;
+    }
+  }
+  std::lock_guard<std::mutex> lock(g_bind_mu);
+  if (bind != nullptr) {
+    g_bound.push_back({handle, bind});
+  }
+  RebindAllLocked();
+  return handle;
+}
+
+void ClosePlugin(void* handle) {
+  if (handle == nullptr) {
+    return;
+  }
+  std::lock_guard<std::mutex> lock(g_bind_mu);
+  for (auto it = g_bound.begin(); it != g_bound.end(); ++it) {
+    if (it->handle == handle) {
+      g_bound.erase(it);
+      break;
+    }
+  }
+  dlclose(handle);
+  RebindAllLocked();
+}
+
+std::string StagePluginCopy(const std::string& source, const std::string& staging_dir,
+                            std::uint64_t tag, std::string* error) {
+  namespace fs = std::filesystem;
+  std::error_code ec;
+  fs::create_directories(staging_dir, ec);
+  const fs::path target =
+      fs::path(staging_dir) / (fs::path(source).filename().string() + "." + std::to_string(tag));
+  if (!ec) {
+    fs::copy_file(source, target, fs::copy_options::overwrite_existing, ec);
+  }
+  if (ec) {
+    SetError(error, "stage " + source + " failed: " + ec.message());
+    return std::string();
+  }
+  return target.string();
+}
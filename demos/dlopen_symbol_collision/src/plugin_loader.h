@@ -0,0 +1,97 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <type_traits>
+
+/*
+ * 插件加载器：dlopen 之后按“声明式符号表”一次性解析所有需要的符号，
+ * 写进一个普通结构体（函数表），之后的调用都走缓存的指针，不再逐次 dlsym。
+ *
+ * 函数表约定：结构体里每个槽位都是一个指针（函数指针或变量指针），
+ * 由 SymbolSpec 用 offsetof 声明“哪个符号名写到哪个槽位”。
+ */
+
+struct SymbolSpec {
+  const char* name;
+  std::size_t offset;
+};
+
+struct PluginSpec {
+  // 插件导出的 ABI 版本函数，签名为 std::uint32_t (*)()；先于其他符号检查。
+  const char* abi_symbol;
+  std::uint32_t expected_abi;
+  const SymbolSpec* symbols;
+  std::size_t symbol_count;
+  // 可选：插件导出的绑定函数，签名为 void (*)()。插件可能在库内缓存 RTLD_DEFAULT 的查找结果，
+  // 而结果取决于当前加载了哪些库；经本加载器每加载或卸载一个插件，都会对所有已加载插件各调用一次。
+  const char* bind_symbol = nullptr;
+};
+
+// 在 handle（可以是 RTLD_DEFAULT）里解析全部符号写入 table；任何一个缺失都返回 false，table 不保证完整。
+bool ResolveSymbolTable(void* handle, const SymbolSpec* symbols, std::size_t count, void* table,
+                        std::size_t table_size, std::string* error);
+
+// dlopen + ABI 版本检查 + 解析符号表 + 重新绑定各插件；失败时已关闭句柄并返回 nullptr。
+void* OpenPlugin(const std::string& path, int flags, const PluginSpec& spec, void* table,
+                 std::size_t table_size, std::string* error);
+
+// dlclose，之后让仍在加载的插件重新绑定。
+void ClosePlugin(void* handle);
+
+// 把插件复制成 <staging_dir>/<文件名>.<tag>，返回新路径（失败返回空串）。
+// 同一路径重复 dlopen 只会得到同一个句柄，热替换时每个版本都要用不同的文件。
+std::string StagePluginCopy(const std::string& source, const std::string& staging_dir,
+                            std::uint64_t tag, std::string* error);
+
+template <typename Table>
+class Plugin final {
+  static_assert(std::is_standard_layout<Table>::value && std::is_trivially_copyable<Table>::value,
+                "plugin table must be a plain struct of pointers");
+
+ public:
+  Plugin() = default;
+  Plugin(const Plugin&) = delete;
+  Plugin& operator=(const Plugin&) = delete;
+
+  ~Plugin() {
+    Close();
+  }
+
+  bool Open(const std::string& path, int flags, const PluginSpec& spec, std::string* error) {
+    Table table{};
+    void* handle = OpenPlugin(path, flags, spec, &table, sizeof(table), error);
+    if (handle == nullptr) {
+      return false;
+    }
+    Close();
+    handle_ = handle;
+    table_ = table;
+    return true;
+  }
+
+  void Close() {
+    if (handle_ != nullptr) {
+      ClosePlugin(handle_);
+      handle_ = nullptr;
+      table_ = Table{};
+    }
+  }
+
+  void* handle() const {
+    return handle_;
+  }
+
+  const Table& operator*() const {
+    return table_;
+  }
+
+  const Table* operator->() const {
+    return &table_;
+  }
+
+ private:
+  void* handle_ = nullptr;
+  Table table_{};
+};
@@ -0,0 +1,302 @@
+#include "demo_plugin.h"
+#include "hot_swap_plugin.h"
+
+#include <dlfcn.h>
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <filesystem>
+#include <iomanip>
+#include <iostream>
+#include <shared_mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+/*
+ * 对数分桶直方图：< 16ns 每 ns 一个桶，之后每个 2 的幂区间再细分 8 个桶（误差约 12%）。
+ * 每个调用方线程一份，结束后合并。
+ */
+constexpr int kLinearBuckets = 16;
+constexpr int kSubBuckets = 8;
+constexpr int kBuckets = kLinearBuckets + (64 - 4) * kSubBuckets;
+
+int BucketOf(std::uint64_t ns) {
+  if (ns < kLinearBuckets) {
+    return static_cast<int>(ns);
+  }
+  const int msb = 63 - __builtin_clzll(ns);
+  return kLinearBuckets + (msb - 4) * kSubBuckets + static_cast<int>((ns >> (msb - 3)) & 7);
+}
+
+std::uint64_t BucketUpperNs(int bucket) {
+  if (bucket < kLinearBuckets) {
+    return static_cast<std::uint64_t>(bucket);
+  }
+  const int msb = (bucket - kLinearBuckets) / kSubBuckets + 4;
+  const std::uint64_t sub = static_cast<std::uint64_t>((bucket - kLinearBuckets) % kSubBuckets);
+  return ((kSubBuckets + sub + 1) << (msb - 3)) - 1;
+}
+
+struct alignas(64) CallerStats {
+  std::array<std::uint64_t, kBuckets> hist{};
+  std::uint64_t calls = 0;
+  std::uint64_t max_ns = 0;
+  std::uint64_t generations_seen = 0;
+  std::int64_t sink = 0;
+
+  void Record(std::uint64_t ns) {
+    ++hist[BucketOf(ns)];
+    ++calls;
+    max_ns = std::max(max_ns, ns);
+  }
+};
+
+struct RunSummary {
+  std::uint64_t calls = 0;
+  std::uint64_t p50_ns = 0;
+  std::uint64_t p99_ns = 0;
+  std::uint64_t p999_ns = 0;
+  std::uint64_t max_ns = 0;
+  std::uint64_t generations_seen = 0;
+  double reload_avg_us = 0;
+  double reload_max_us = 0;
+  std::size_t max_pending = 0;
+};
+
+RunSummary Summarize(const std::vector<CallerStats>& callers) {
+  RunSummary summary;
+  std::array<std::uint64_t, kBuckets> merged{};
+  for (const auto& caller : callers) {
+    for (int b = 0; b < kBuckets; ++b) {
+      merged[b] += caller.hist[b];
+    }
+    summary.calls += caller.calls;
+    summary.max_ns = std::max(summary.max_ns, caller.max_ns);
+    summary.generations_seen = std::max(summary.generations_seen, caller.generations_seen);
+  }
+  const auto percentile = [&](double q) {
+    const auto target = static_cast<std::uint64_t>(q * static_cast<double>(summary.calls));
+    std::uint64_t seen = 0;
+    for (int b = 0; b < kBuckets; ++b) {
+      seen += merged[b];
+      if (seen > target) {
+        return BucketUpperNs(b);
+      }
+    }
+    return summary.max_ns;
+  };
+  summary.p50_ns = percentile(0.50);
+  summary.p99_ns = percentile(0.99);
+  summary.p999_ns = percentile(0.999);
+  return summary;
+}
+
+struct BenchConfig {
+  std::filesystem::path build_dir;
+  int callers = 4;
+  int reloads = 50;
+  int interval_ms = 20;
+};
+
+// 两种发布方式的公共接口：epoch 指针交换，以及对照组“读写锁 + 持锁 reload”。
+class EpochTarget final {
+ public:
+  bool Reload(const BenchConfig& cfg, std::uint64_t generation, std::string* error) {
+    const std::string staged = StageDemoOneGeneration(cfg.build_dir, generation, error);
+    const bool ok = !staged.empty() &&
+                    plugin_.Reload(staged, RTLD_NOW | RTLD_LOCAL, kDemoOneReloadSpec, error);
+    if (!staged.empty()) {
+      std::filesystem::remove(staged);
+    }
+    plugin_.ReclaimRetired();
+    return ok;
+  }
+
+  std::size_t Pending() {
+    return plugin_.RetiredCount();
+  }
+
+  void Finish() {
+    plugin_.ReclaimRetired();
+  }
+
+  void CallerLoop(const std::atomic<bool>& stop, CallerStats& stats) {
+    const int slot = plugin_.RegisterReader();
+    std::uint64_t last_id = 0;
+    int x = 0;
+    while (!stop.load(std::memory_order_relaxed)) {
+      const auto begin = Clock::now();
+      {
+        HotSwapPlugin<DemoOneReloadTable>::ReadGuard guard(plugin_, slot);
+        stats.sink += guard->shared_compute(x++ & 0xff);
+        if (guard.generation()->id != last_id) {
+          last_id = guard.generation()->id;
+          ++stats.generations_seen;
+        }
+      }
+      stats.Record(static_cast<std::uint64_t>(
+          std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - begin).count()));
+    }
+  }
+
+ private:
+  HotSwapPlugin<DemoOneReloadTable> plugin_;
+};
+
+class RwLockTarget final {
+ public:
+  bool Reload(const BenchConfig& cfg, std::uint64_t generation, std::string* error) {
+    const std::string staged = StageDemoOneGeneration(cfg.build_dir, generation, error);
+    bool ok = false;
+    if (!staged.empty()) {
+      // 持写锁完成 dlopen + 解析 + dlclose 旧版本：这段时间所有调用方都被挡住。
+      std::unique_lock<std::shared_mutex> lock(mu_);
+      ok = plugin_.Open(staged, RTLD_NOW | RTLD_LOCAL, kDemoOneReloadSpec, error);
+      ++generation_;
+    }
+    if (!staged.empty()) {
+      std::filesystem::remove(staged);
+    }
+    return ok;
+  }
+
+  std::size_t Pending() {
+    return 0;
+  }
+
+  void Finish() {}
+
+  void CallerLoop(const std::atomic<bool>& stop, CallerStats& stats) {
+    std::uint64_t last_id = 0;
+    int x = 0;
+    while (!stop.load(std::memory_order_relaxed)) {
+      const auto begin = Clock::now();
+      {
+        std::shared_lock<std::shared_mutex> lock(mu_);
+        stats.sink += plugin_->shared_compute(x++ & 0xff);
+        if (generation_ != last_id) {
+          last_id = generation_;
+          ++stats.generations_seen;
+        }
+      }
+      stats.Record(static_cast<std::uint64_t>(
+          std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - begin).count()));
+    }
+  }
+
+ private:
+  std::shared_mutex mu_;
+  Plugin<DemoOneReloadTable> plugin_;
+  std::uint64_t generation_ = 0;
+};
+
+// reloads == 0 时只跑同样时长的调用，作为没有替换时的基线。
+template <typename Target>
+bool RunScenario(const BenchConfig& cfg, int reloads, RunSummary& summary) {
+  Target target;
+  std::string error;
+  if (!target.Reload(cfg, 1, &error)) {
+    std::cerr << error << '\n';
+    return false;
+  }
+
+  std::atomic<bool> stop{false};
+  std::vector<CallerStats> callers(cfg.callers);
+  std::vector<std::thread> threads;
+  for (int t = 0; t < cfg.callers; ++t) {
+    threads.emplace_back([&target, &stop, &callers, t]() { target.CallerLoop(stop, callers[t]); });
+  }
+
+  double reload_total_us = 0;
+  double reload_max_us = 0;
+  std::size_t max_pending = 0;
+  bool ok = true;
+  const int rounds = reloads > 0 ? reloads : cfg.reloads;
+  for (int r = 0; r < rounds && ok; ++r) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(cfg.interval_ms));
+    if (reloads == 0) {
+      continue;
+    }
+    const auto begin = Clock::now();
+    ok = target.Reload(cfg, static_cast<std::uint64_t>(r) + 2, &error);
+    const double us = std::chrono::duration<double, std::micro>(Clock::now() - begin).count();
+    reload_total_us += us;
+    reload_max_us = std::max(reload_max_us, us);
+    max_pending = std::max(max_pending, target.Pending());
+  }
+
+  stop.store(true, std::memory_order_relaxed);
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  target.Finish();
+  if (!ok) {
+    std::cerr << error << '\n';
+    return false;
+  }
+
+  summary = Summarize(callers);
+  summary.reload_avg_us = reloads > 0 ? reload_total_us / reloads : 0;
+  summary.reload_max_us = reload_max_us;
+  summary.max_pending = max_pending;
+  return true;
+}
+
+void PrintRow(const char* name, const RunSummary& s) {
+  std::cout << std::left << std::setw(22) << name << std::right << std::setw(11) << s.calls
+            << std::setw(8) << s.p50_ns << std::setw(8) << s.p99_ns << std::setw(9)
+            << s.p999_ns << std::setw(10) << s.max_ns << std::setw(6) << s.generations_seen
+            << std::fixed << std::setprecision(1) << std::setw(12) << s.reload_avg_us
+            << std::setw(12) << s.reload_max_us << std::setw(9) << s.max_pending << '\n';
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  BenchConfig cfg;
+  cfg.callers = argc >= 2 ? std::atoi(argv[1]) : 4;
+  cfg.reloads = argc >= 3 ? std::atoi(argv[2]) : 50;
+  cfg.interval_ms = argc >= 4 ? std::atoi(argv[3]) : 20;
+  if (cfg.callers <= 0 || cfg.callers > EpochDomain::kMaxReaders || cfg.reloads <= 0 ||
+      cfg.interval_ms <= 0) {
+    std::cerr << "usage: " << argv[0] << " [callers<=" << EpochDomain::kMaxReaders
+              << "] [reloads] [interval_ms]\n";
+    return 2;
+  }
+  cfg.build_dir = std::filesystem::canonical(std::filesystem::path(argv[0])).parent_path();
+
+  std::cout << "== demo_one hot reload: caller latency across repeated reloads ==\n"
+            << cfg.callers << " caller threads, " << cfg.reloads << " reloads every "
+            << cfg.interval_ms << "ms (demo_one <-> demo_one_v2)\n"
+            << "latency percentiles are histogram bucket upper bounds (~12%), in ns, "
+               "including the clock read\n\n"
+            << std::left << std::setw(22) << "MODE" << std::right << std::setw(11) << "CALLS"
+            << std::setw(8) << "p50" << std::setw(8) << "p99" << std::setw(9) << "p99.9"
+            << std::setw(10) << "max" << std::setw(6) << "GENS" << std::setw(12)
+            << "reload avg" << std::setw(12) << "reload max" << std::setw(9) << "PENDING"
+            << '\n';
+
+  RunSummary summary;
+  if (!RunScenario<EpochTarget>(cfg, 0, summary)) {
+    return 1;
+  }
+  PrintRow("epoch, no reload", summary);
+  if (!RunScenario<EpochTarget>(cfg, cfg.reloads, summary)) {
+    return 1;
+  }
+  PrintRow("epoch swap", summary);
+  if (!RunScenario<RwLockTarget>(cfg, cfg.reloads, summary)) {
+    return 1;
+  }
+  PrintRow("rwlock + locked reload", summary);
+  return 0;
+}
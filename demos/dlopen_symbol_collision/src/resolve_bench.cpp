@@ -0,0 +1,121 @@
+#include "demo_plugin.h"
+
+#include <dlfcn.h>
+
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <filesystem>
+#include <iomanip>
+#include <iostream>
+#include <string>
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+// 结果累加进 volatile，防止编译器把调用或读取当成死代码删掉。
+volatile std::int64_t g_sink = 0;
+
+template <typename Body>
+double NsPerCall(std::uint64_t iterations, Body body) {
+  std::int64_t acc = 0;
+  const auto begin = Clock::now();
+  for (std::uint64_t i = 0; i < iterations; ++i) {
+    acc += body(static_cast<int>(i & 0xff));
+  }
+  const std::chrono::duration<double, std::nano> elapsed = Clock::now() - begin;
+  g_sink = g_sink + acc;
+  return elapsed.count() / static_cast<double>(iterations);
+}
+
+template <typename T>
+T Lookup(void* handle, const char* name) {
+  return reinterpret_cast<T>(dlsym(handle, name));
+}
+
+void PrintRow(const char* name, double per_call_ns, double cached_ns) {
+  std::cout << std::left << std::setw(40) << name << std::right << std::fixed
+            << std::setprecision(1) << std::setw(12) << per_call_ns << std::setw(12)
+            << cached_ns << std::setw(10) << per_call_ns / cached_ns << "x\n";
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  const std::uint64_t iterations = argc >= 2 ? std::strtoull(argv[1], nullptr, 10) : 2000000;
+  if (iterations == 0) {
+    std::cerr << "usage: " << argv[0] << " [iterations]\n";
+    return 2;
+  }
+
+  const std::filesystem::path build_dir =
+      std::filesystem::canonical(std::filesystem::path(argv[0])).parent_path();
+
+  Plugin<DemoPluginTable> one;
+  Plugin<DemoPluginTable> two;
+  std::string error;
+  if (!one.Open((build_dir / (std::string(DEMO_LIB_PREFIX) + "demo_one" + DEMO_LIB_SUFFIX))
+                    .string(),
+                RTLD_NOW | RTLD_GLOBAL, kDemoOneSpec, &error) ||
+      !two.Open((build_dir / (std::string(DEMO_LIB_PREFIX) + "demo_two" + DEMO_LIB_SUFFIX))
+                    .string(),
+                RTLD_NOW | RTLD_GLOBAL, kDemoTwoSpec, &error)) {
+    std::cerr << error << '\n';
+    return 1;
+  }
+
+  DefaultSymbolTable defaults{};
+  if (!ResolveSymbolTable(RTLD_DEFAULT, kDefaultSymbols,
+                          sizeof(kDefaultSymbols) / sizeof(kDefaultSymbols[0]), &defaults,
+                          sizeof(defaults), &error)) {
+    std::cerr << error << '\n';
+    return 1;
+  }
+
+  void* handle = two.handle();
+  std::cout << "== dlsym per call vs cached plugin table ==\n"
+            << "iterations: " << iterations << " (demo_one, demo_two loaded RTLD_GLOBAL)\n\n"
+            << std::left << std::setw(40) << "SYMBOL" << std::right << std::setw(12)
+            << "dlsym ns" << std::setw(12) << "cached ns" << std::setw(11) << "speedup\n";
+
+  PrintRow("shared_compute (demo_two handle)",
+           NsPerCall(iterations,
+                     [handle](int x) {
+                       return Lookup<int (*)(int)>(handle, "shared_compute")(x);
+                     }),
+           NsPerCall(iterations, [&two](int x) { return two->shared_compute(x); }));
+
+  PrintRow("demo_two_snapshot (demo_two handle)",
+           NsPerCall(iterations,
+                     [handle](int x) {
+                       return Lookup<DemoSnapshot (*)(int)>(handle, "demo_two_snapshot")(x)
+                           .shared_fn_result;
+                     }),
+           NsPerCall(iterations, [&two](int x) { return two->snapshot(x).shared_fn_result; }));
+
+  PrintRow("shared_compute (RTLD_DEFAULT)",
+           NsPerCall(iterations,
+                     [](int x) {
+                       return Lookup<int (*)(int)>(RTLD_DEFAULT, "shared_compute")(x);
+                     }),
+           NsPerCall(iterations, [&defaults](int x) { return defaults.shared_compute(x); }));
+
+  PrintRow("g_shared_value (RTLD_DEFAULT)",
+           NsPerCall(iterations,
+                     [](int x) { return *Lookup<int*>(RTLD_DEFAULT, "g_shared_value") + x; }),
+           NsPerCall(iterations, [&defaults](int x) { return *defaults.shared_value + x; }));
+
+  // 一次性解析整张表的成本：加载时付一次，之后每次调用都省掉上面的 dlsym。
+  const std::uint64_t resolve_rounds = iterations / 100 + 1;
+  const double resolve_ns = NsPerCall(resolve_rounds, [handle, &error](int) {
+    DemoPluginTable table{};
+    ResolveSymbolTable(handle, kDemoTwoSymbols,
+                       sizeof(kDemoTwoSymbols) / sizeof(kDemoTwoSymbols[0]), &table,
+                       sizeof(table), &error);
+    return table.shared_compute != nullptr ? 1 : 0;
+  });
+  std::cout << "\none-time resolve of the " << sizeof(kDemoTwoSymbols) / sizeof(kDemoTwoSymbols[0])
+            << "-symbol table: " << std::setprecision(1) << resolve_ns << " ns\n";
+  return 0;
+}
@@ -0,0 +1,222 @@
+#include "api.h"
+
+#include <dlfcn.h>
+#include <link.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <iomanip>
+#include <iostream>
+#include <string>
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+constexpr int kRepeats = 5;
+constexpr int kProbeArg = 7;
+
+// 与 CMakeLists.txt 里的 DEMO_LIB_VARIANTS 保持一致。
+struct Variant {
+  const char* name;
+  const char* flags;
+};
+
+const Variant kVariants[] = {
+    {"default", "(none)"},
+    {"hidden", "-fvisibility=hidden + DEMO_EXPORT"},
+    {"bsymbolic", "-Wl,-Bsymbolic"},
+    {"nosemantic", "-fno-semantic-interposition"},
+    {"noplt", "-fno-plt"},
+};
+
+struct VariantResult {
+  bool ok = false;
+  char error[160] = {};
+  double ns_per_call = 0;
+  long symbol_relocs = 0;
+  // demo_two_snapshot(kProbeArg) 里库内直接调用 / 读取同名符号的结果。
+  int fn_result = 0;
+  // 宿主视角：RTLD_DEFAULT 能否找到 shared_compute，以及找到的是谁。
+  bool default_visible = false;
+  int default_fn_result = 0;
+};
+
+/*
+ * 统计按符号名绑定的动态重定位条数（.rela.dyn 的 GLOB_DAT 等 + .rela.plt 的 JUMP_SLOT）。
+ * 每一条都是一次加载时的符号查找，也是一个可被其他库抢占的引用；RELATIVE 重定位不计入。
+ */
+long CountSymbolRelocs(void* handle) {
+  link_map* map = nullptr;
+  if (dlinfo(handle, RTLD_DI_LINKMAP, &map) != 0 || map == nullptr) {
+    return -1;
+  }
+  ElfW(Addr) rela = 0;
+  ElfW(Xword) rela_size = 0;
+  ElfW(Addr) jmprel = 0;
+  ElfW(Xword) jmprel_size = 0;
+  for (const ElfW(Dyn)* dyn = map->l_ld; dyn->d_tag != DT_NULL; ++dyn) {
+    if (dyn->d_tag == DT_RELA) {
+      rela = dyn->d_un.d_ptr;
+    } else if (dyn->d_tag == DT_RELASZ) {
+      rela_size = dyn->d_un.d_val;
+    } else if (dyn->d_tag == DT_JMPREL) {
+      jmprel = dyn->d_un.d_ptr;
+    } else if (dyn->d_tag == DT_PLTRELSZ) {
+      jmprel_size = dyn->d_un.d_val;
+    }
+  }
+
+  long count = 0;
+  const auto count_table = [map, &count](ElfW(Addr) addr, ElfW(Xword) size) {
+    if (addr == 0) {
+      return;
+    }
+    // glibc 在 x86_64 上会把动态段里的地址改写成绝对地址，未改写时补上加载基址。
+    if (addr < map->l_addr) {
+      addr += map->l_addr;
+    }
+    const auto* entries = reinterpret_cast<const ElfW(Rela)*>(addr);
+    for (ElfW(Xword) i = 0; i < size / sizeof(ElfW(Rela)); ++i) {
+      if (ELF64_R_SYM(entries[i].r_info) != 0) {
+        ++count;
+      }
+    }
+  };
+  count_table(rela, rela_size);
+  count_table(jmprel, jmprel_size);
+  return count;
+}
+
+VariantResult RunVariant(const std::filesystem::path& dir, std::uint64_t iterations) {
+  VariantResult result;
+  const std::string one_path =
+      (dir / (std::string(DEMO_LIB_PREFIX) + "demo_one" + DEMO_LIB_SUFFIX)).string();
+  const std::string two_path =
+      (dir / (std::string(DEMO_LIB_PREFIX) + "demo_two" + DEMO_LIB_SUFFIX)).string();
+
+  // 与 dlopen_symbol_demo 12 相同：先 demo_one 后 demo_two，都进全局作用域。
+  void* one = dlopen(one_path.c_str(), RTLD_NOW | RTLD_GLOBAL);
+  void* two = one ? dlopen(two_path.c_str(), RTLD_NOW | RTLD_GLOBAL) : nullptr;
+  auto* snapshot =
+      two ? reinterpret_cast<DemoSnapshot (*)(int)>(dlsym(two, "demo_two_snapshot")) : nullptr;
+  auto* bench = two ? reinterpret_cast<std::int64_t (*)(std::uint64_t)>(
+                          dlsym(two, "demo_two_bench_shared_compute"))
+                    : nullptr;
+  if (snapshot == nullptr || bench == nullptr) {
+    const char* err = dlerror();
+    std::snprintf(result.error, sizeof(result.error), "%s", err ? err : "load failed");
+    return result;
+  }
+
+  const DemoSnapshot snap = snapshot(kProbeArg);
+  result.fn_result = snap.shared_fn_result;
+  result.default_visible = snap.default_shared_fn_addr != 0;
+  result.default_fn_result = snap.default_shared_fn_result;
+  result.symbol_relocs = CountSymbolRelocs(two);
+
+  bench(iterations / 10);
+  double best_ns = 0;
+  for (int r = 0; r < kRepeats; ++r) {
+    const auto begin = Clock::now();
+    const std::int64_t acc = bench(iterations);
+    const std::chrono::duration<double, std::nano> elapsed = Clock::now() - begin;
+    const double ns = elapsed.count() / static_cast<double>(iterations);
+    best_ns = r == 0 ? ns : std::min(best_ns, ns);
+    if (acc == 0) {
+      std::snprintf(result.error, sizeof(result.error), "unexpected zero checksum");
+      return result;
+    }
+  }
+  result.ns_per_call = best_ns;
+  result.ok = true;
+  return result;
+}
+
+// 每个变体在独立子进程里加载：同名库一旦进了全局作用域就无法干净地换成另一个变体。
+bool RunVariantInChild(const std::filesystem::path& dir, std::uint64_t iterations,
+                       VariantResult& result) {
+  int fds[2];
+  if (::pipe(fds) != 0) {
+    return false;
+  }
+  std::cout.flush();
+  const pid_t pid = ::fork();
+  if (pid == 0) {
+    ::close(fds[0]);
+    const VariantResult child = RunVariant(dir, iterations);
+    const ssize_t written = ::write(fds[1], &child, sizeof(child));
+    ::_exit(written == static_cast<ssize_t>(sizeof(child)) ? 0 : 1);
+  }
+  ::close(fds[1]);
+  const bool ok =
+      pid > 0 && ::read(fds[0], &result, sizeof(result)) == static_cast<ssize_t>(sizeof(result));
+  ::close(fds[0]);
+  if (pid > 0) {
+    ::waitpid(pid, nullptr, 0);
+  }
+  return ok;
+}
+
+/*
+ * demo_one: shared_compute(x) = 111 + x + 1，demo_two: 222 + x + 2。
+ * 由 demo_two 库内调用 shared_compute(7) 的结果反推绑定到了谁：
+ *   231 = 自己的函数 + 自己的变量；120 = 自己的函数 + demo_one 的变量；119 = demo_one 的函数。
+ */
+std::string DescribeBinding(const VariantResult& r) {
+  const int own_fn_base = r.fn_result - kProbeArg - 2;
+  const bool own_fn = own_fn_base == 111 || own_fn_base == 222;
+  std::string text = own_fn ? "fn own" : "fn interposed";
+  if (own_fn) {
+    text += own_fn_base == 222 ? ", var own" : ", var interposed";
+  }
+  return text;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  const std::uint64_t iterations = argc >= 2 ? std::strtoull(argv[1], nullptr, 10) : 50000000;
+  if (iterations == 0) {
+    std::cerr << "usage: " << argv[0] << " [iterations]\n";
+    return 2;
+  }
+  const std::filesystem::path variants_dir =
+      std::filesystem::canonical(std::filesystem::path(argv[0])).parent_path() / "variants";
+
+  std::cout << "== shared_compute call cost inside demo_two, by build variant ==\n"
+            << "load order: demo_one -> demo_two (RTLD_NOW | RTLD_GLOBAL), " << iterations
+            << " calls, best of " << kRepeats << "\n\n"
+            << std::left << std::setw(12) << "VARIANT" << std::setw(36) << "FLAGS"
+            << std::right << std::setw(9) << "ns/call" << std::setw(12) << "SYM RELOCS"
+            << std::setw(8) << "fn(7)" << "  " << std::left << std::setw(26)
+            << "IN-LIBRARY BINDING" << "RTLD_DEFAULT shared_compute\n";
+
+  for (const Variant& variant : kVariants) {
+    VariantResult r;
+    if (!RunVariantInChild(variants_dir / variant.name, iterations, r)) {
+      std::cerr << "benchmark child failed for " << variant.name << '\n';
+      return 1;
+    }
+    std::cout << std::left << std::setw(12) << variant.name << std::setw(36) << variant.flags;
+    if (!r.ok) {
+      std::cout << "error: " << r.error << '\n';
+      continue;
+    }
+    std::cout << std::right << std::fixed << std::setprecision(2) << std::setw(9)
+              << r.ns_per_call << std::setw(12) << r.symbol_relocs << std::setw(8) << r.fn_result
+              << "  " << std::left << std::setw(26) << DescribeBinding(r);
+    if (r.default_visible) {
+      std::cout << "exported, resolves to fn(7)=" << r.default_fn_result << '\n';
+    } else {
+      std::cout << "not exported\n";
+    }
+  }
+  return 0;
+}
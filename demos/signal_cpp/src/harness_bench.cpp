@@ -0,0 +1,88 @@
+#include <csignal>
+#include <cstdint>
+#include <ctime>
+#include <iostream>
+
+#include "bench_harness.h"
+#include "stats.h"
+#include "worker.h"
+
+namespace {
+
+volatile std::sig_atomic_t g_usr1_count = 0;
+
+void OnUsr1(int) { g_usr1_count = g_usr1_count + 1; }
+
+std::uint64_t NowNs() {
+  timespec ts{};
+  ::clock_gettime(CLOCK_MONOTONIC, &ts);
+  return static_cast<std::uint64_t>(ts.tv_sec) * 1000000000ull +
+         static_cast<std::uint64_t>(ts.tv_nsec);
+}
+
+}  // namespace
+
+/*
+ * signal_cpp 各热路径的统一格式 benchmark：
+ * - worker 每个请求的负载（RunWorkUnit），以及叠加在它上面的计数 / 采样计时成本；
+ * - 主循环处理 SIGUSR1 时的 Collect()；
+ * - 同线程 raise() 到 handler 返回的往返延迟（主循环“收到信号”的最短路径）。
+ */
+int main(int argc, char** argv) {
+  struct sigaction sa{};
+  sa.sa_handler = OnUsr1;
+  sigemptyset(&sa.sa_mask);
+  if (::sigaction(SIGUSR1, &sa, nullptr) != 0) {
+    std::cerr << "sigaction(SIGUSR1) failed\n";
+    return 1;
+  }
+
+  signal_stats::ThreadStats* stats = signal_stats::StatsRegistry::Instance().AcquireSlot();
+  if (stats == nullptr) {
+    std::cerr << "no stats slot\n";
+    return 1;
+  }
+
+  bench::Suite suite("signal_cpp");
+  suite.Add("RunWorkUnit", [](bench::State& state) {
+    std::uint64_t seed = 1;
+    for (std::uint64_t i = 0; i < state.iterations(); ++i) {
+      seed = signal_stats::RunWorkUnit(seed);
+    }
+    bench::DoNotOptimize(seed);
+  });
+
+  suite.Add("ThreadStats::CountOp", [stats](bench::State& state) {
+    for (std::uint64_t i = 0; i < state.iterations(); ++i) {
+      bool sampled = stats->CountOp();
+      bench::DoNotOptimize(sampled);
+    }
+  });
+
+  // 与 WorkerLoop 相同：每 kLatencySampleEvery 次操作读两次时钟并记一次延迟。
+  suite.Add("RunWorkUnit+stats", [stats](bench::State& state) {
+    std::uint64_t seed = 1;
+    for (std::uint64_t i = 0; i < state.iterations(); ++i) {
+      if (stats->CountOp()) {
+        const std::uint64_t begin = NowNs();
+        seed = signal_stats::RunWorkUnit(seed);
+        stats->RecordLatency(NowNs() - begin);
+      } else {
+        seed = signal_stats::RunWorkUnit(seed);
+      }
+    }
+    bench::DoNotOptimize(seed);
+  });
+
+  suite.AddLatency("StatsRegistry::Collect", [] {
+    signal_stats::Snapshot snapshot = signal_stats::StatsRegistry::Instance().Collect();
+    bench::DoNotOptimize(snapshot);
+  });
+
+  suite.AddLatency("raise(SIGUSR1)->handler", [] {
+    ::raise(SIGUSR1);
+    bench::ClobberMemory();
+  });
+
+  return suite.Run(argc, argv);
+}
@@ -1,13 +1,23 @@
+#include <atomic>
 #include <cerrno>
 #include <csignal>
+#include <cstdlib>
 #include <cstring>
 #include <iomanip>
 #include <iostream>
 #include <string>
+#include <thread>
 #include <vector>
 
+#include <pthread.h>
 #include <unistd.h>
 
+#include "async_log.h"
+#include "profiler.h"
+#include "stats.h"
+#include "supervisor.h"
+#include "worker.h"
+
 namespace {
 
 #if defined(NSIG)
@@ -31,6 +41,21 @@ struct RegisterResult {
   int err;
 };
 
+struct Options {
+  // 后台 worker 线程数；0 表示只做信号注册演示。
+  int workers = 0;
+  // SIGUSR1 统计快照输出位置，空表示 stdout。
+  std::string stats_file;
+  // SIGPROF 采样频率；0 表示不启用 profiler。
+  int profile_hz = 0;
+  signal_prof::TimerMode profile_mode = signal_prof::TimerMode::kProcess;
+  // folded stacks 输出位置，空表示 stdout。
+  std::string profile_out;
+  // >0 时进入 prefork 监督模式，不再运行信号注册演示。
+  int supervise = 0;
+  signal_supervisor::SupervisorConfig supervisor;
+};
+
 volatile std::sig_atomic_t g_pending[kSignalSlots] = {};
 volatile std::sig_atomic_t g_exit_requested = 0;
 
@@ -217,9 +242,175 @@ void PrintRegistrationTable(const std::vector<RegisterResult>& results) {
   }
 }
 
+bool ParseBoundedInt(const char* text, long min, long max, int& value) {
+  char* end = nullptr;
+  const long parsed = std::strtol(text, &end, 10);
+  if (end == text || *end != '\0' || parsed < min || parsed > max) {
+    return false;
+  }
+  value = static_cast<int>(parsed);
+  return true;
+}
+
+bool ParseOptions(int argc, char** argv, Options& options, std::string& error) {
+  for (int i = 1; i < argc; ++i) {
+    const std::string arg = argv[i];
+    if (arg == "--workers") {
+      if (i + 1 >= argc) {
+        error = "--workers requires a value";
+        return false;
+      }
+      if (!ParseBoundedInt(argv[++i], 0, signal_stats::kMaxThreads, options.workers)) {
+        error = "invalid --workers, expected 0.." +
+                std::to_string(signal_stats::kMaxThreads);
+        return false;
+      }
+      continue;
+    }
+
+    if (arg == "--profile-hz") {
+      if (i + 1 >= argc) {
+        error = "--profile-hz requires a value";
+        return false;
+      }
+      if (!ParseBoundedInt(argv[++i], 0, 100000, options.profile_hz)) {
+        error = "invalid --profile-hz, expected 0..100000";
+        return false;
+      }
+      continue;
+    }
+
+    if (arg == "--profile-mode") {
+      if (i + 1 >= argc) {
+        error = "--profile-mode requires a value";
+        return false;
+      }
+      const std::string mode = argv[++i];
+      if (mode == "process") {
+        options.profile_mode = signal_prof::TimerMode::kProcess;
+      } else if (mode == "thread") {
+        options.profile_mode = signal_prof::TimerMode::kThreadCpu;
+      } else {
+        error = "invalid --profile-mode, expected process|thread";
+        return false;
+      }
+      continue;
+    }
+
+    if (arg == "--supervise") {
+      if (i + 1 >= argc) {
+        error = "--supervise requires a value";
+        return false;
+      }
+      if (!ParseBoundedInt(argv[++i], 0, 1024, options.supervise)) {
+        error = "invalid --supervise, expected 0..1024";
+        return false;
+      }
+      continue;
+    }
+
+    if (arg == "--crash-after-ms") {
+      if (i + 1 >= argc) {
+        error = "--crash-after-ms requires a value";
+        return false;
+      }
+      if (!ParseBoundedInt(argv[++i], 0, 3600000, options.supervisor.crash_after_ms)) {
+        error = "invalid --crash-after-ms, expected 0..3600000";
+        return false;
+      }
+      continue;
+    }
+
+    if (arg == "--run-seconds") {
+      if (i + 1 >= argc) {
+        error = "--run-seconds requires a value";
+        return false;
+      }
+      char* end = nullptr;
+      const char* text = argv[++i];
+      options.supervisor.run_seconds = std::strtod(text, &end);
+      if (end == text || *end != '\0' || options.supervisor.run_seconds < 0) {
+        error = "invalid --run-seconds, expected a non-negative number";
+        return false;
+      }
+      continue;
+    }
+
+    if (arg == "--profile-out") {
+      if (i + 1 >= argc) {
+        error = "--profile-out requires a value";
+        return false;
+      }
+      options.profile_out = argv[++i];
+      continue;
+    }
+
+    if (arg == "--stats-file") {
+      if (i + 1 >= argc) {
+        error = "--stats-file requires a value";
+        return false;
+      }
+      options.stats_file = argv[++i];
+      continue;
+    }
+
+    error = "unknown option: " + arg;
+    return false;
+  }
+  return true;
+}
+
+/*
+ * 启动 worker 线程。
+ * 创建线程前先屏蔽所有可屏蔽信号（SIGPROF 除外），新线程继承该掩码，
+ * 这样控制类信号只会投递给主线程，pause() 才能被可靠唤醒；
+ * SIGPROF 保持放开，profiler 才能采到 worker 的栈。
+ */
+std::vector<std::thread> StartWorkers(int count, const std::atomic<bool>& stop) {
+  sigset_t all;
+  sigset_t previous;
+  sigfillset(&all);
+#ifdef SIGPROF
+  sigdelset(&all, SIGPROF);
+#endif
+  ::pthread_sigmask(SIG_BLOCK, &all, &previous);
+
+  std::vector<std::thread> workers;
+  workers.reserve(count);
+  for (int i = 0; i < count; ++i) {
+    workers.emplace_back([&stop]() {
+      std::string error;
+      if (!signal_prof::Profiler::Instance().RegisterCurrentThread(error)) {
+        std::cerr << "profiler: " << error << '\n';
+      }
+      signal_stats::WorkerLoop(stop, signal_stats::StatsRegistry::Instance().AcquireSlot());
+    });
+  }
+
+  ::pthread_sigmask(SIG_SETMASK, &previous, nullptr);
+  return workers;
+}
+
 }  // namespace
 
-int main() {
+int main(int argc, char** argv) {
+  Options options;
+  std::string error;
+  if (!ParseOptions(argc, argv, options, error)) {
+    std::cerr << "error: " << error << '\n'
+              << "usage: " << argv[0]
+              << " [--workers N] [--stats-file PATH]"
+                 " [--profile-hz HZ] [--profile-mode process|thread] [--profile-out PATH]\n"
+              << "       " << argv[0]
+              << " --supervise N [--crash-after-ms MS] [--run-seconds S]\n";
+    return 2;
+  }
+
+  if (options.supervise > 0) {
+    options.supervisor.workers = options.supervise;
+    return signal_supervisor::RunSupervisor(options.supervisor);
+  }
+
   const auto specs = BuildSignalSpecs();
   std::vector<RegisterResult> results;
   results.reserve(specs.size());
@@ -241,10 +432,12 @@ int main() {
 
   std::cout << "\nQuick try (another terminal):\n";
 #ifdef SIGUSR1
-  std::cout << "  kill -USR1 " << ::getpid() << '\n';
+  std::cout << "  kill -USR1 " << ::getpid()
+            << (options.workers > 0 ? "    # dump runtime stats" : "") << '\n';
 #endif
 #ifdef SIGUSR2
-  std::cout << "  kill -USR2 " << ::getpid() << '\n';
+  std::cout << "  kill -USR2 " << ::getpid()
+            << (options.profile_hz > 0 ? "    # write folded stacks" : "") << '\n';
 #endif
 #ifdef SIGTERM
   std::cout << "  kill -TERM " << ::getpid() << "    # graceful exit\n";
@@ -258,8 +451,37 @@ int main() {
 
   std::cout << "Press Ctrl+C to exit, or send SIGTERM/SIGQUIT.\n\n";
 
+  // profiler 在注册表之后启动，用自己的 sigaction 接管 SIGPROF。
+  auto& profiler = signal_prof::Profiler::Instance();
+  if (options.profile_hz > 0) {
+    if (!profiler.Start(options.profile_hz, options.profile_mode, error)) {
+      std::cerr << "profiler: " << error << '\n';
+      return 1;
+    }
+    std::cout << "SIGPROF sampling profiler at " << options.profile_hz << " Hz ("
+              << (options.profile_mode == signal_prof::TimerMode::kProcess
+                      ? "setitimer(ITIMER_PROF)"
+                      : "per-thread CLOCK_THREAD_CPUTIME_ID")
+              << "), folded stacks -> "
+              << (options.profile_out.empty() ? "stdout" : options.profile_out) << '\n';
+  }
+
+  std::atomic<bool> stop_workers{false};
+  std::vector<std::thread> workers = StartWorkers(options.workers, stop_workers);
+  if (options.workers > 0) {
+    std::cout << "Started " << options.workers << " worker thread(s), stats -> "
+              << (options.stats_file.empty() ? "stdout" : options.stats_file) << "\n\n";
+  }
+
   std::vector<int> received_count(kSignalSlots, 0);
 
+  // 主循环里的事件行交给异步日志，信号风暴时主线程不会卡在终端/管道的 write 上。
+  // 之后仍有 std::cout 输出（统计快照、folded stacks）的地方先 Flush，保持先后顺序。
+  std::cout.flush();
+  if (!async_log::Logger::Instance().Start(async_log::LoggerOptions{}, error)) {
+    std::cerr << "async_log: " << error << '\n';
+  }
+
   while (!g_exit_requested) {
     // pause 阻塞等待任意信号到来，避免 busy-loop 占 CPU。
     ::pause();
@@ -284,10 +506,49 @@ int main() {
         text = "unknown";
       }
 
-      std::cout << "[caught] " << SignalNameByNumber(result.sig, specs)
-                << "(" << result.sig << ")"
-                << ", desc=\"" << text << "\""
-                << ", count=" << received_count[result.sig] << '\n';
+      async_log::LogLine() << "[caught] " << SignalNameByNumber(result.sig, specs)
+                           << "(" << result.sig << ")"
+                           << ", desc=\"" << text << "\""
+                           << ", count=" << received_count[result.sig];
+
+#ifdef SIGUSR1
+      // collector 在主线程汇总各线程计数槽，worker 完全不受影响。
+      if (result.sig == SIGUSR1 && options.workers > 0) {
+        async_log::Logger::Instance().Flush();
+        const auto snapshot = signal_stats::StatsRegistry::Instance().Collect();
+        if (!signal_stats::DumpSnapshot(options.stats_file, snapshot)) {
+          std::cerr << "failed to write stats to " << options.stats_file << '\n';
+        }
+        std::cout.flush();
+      }
+#endif
+#ifdef SIGUSR2
+      if (result.sig == SIGUSR2 && profiler.running()) {
+        async_log::Logger::Instance().Flush();
+        if (!profiler.WriteFolded(options.profile_out)) {
+          std::cerr << "failed to write folded stacks to " << options.profile_out << '\n';
+        }
+        std::cout.flush();
+      }
+#endif
+    }
+  }
+
+  stop_workers.store(true, std::memory_order_relaxed);
+  for (auto& worker : workers) {
+    worker.join();
+  }
+  async_log::Logger::Instance().Stop();
+  if (options.workers > 0) {
+    signal_stats::WriteSnapshot(std::cout, signal_stats::StatsRegistry::Instance().Collect());
+  }
+  if (profiler.running()) {
+    profiler.Stop();
+    const auto prof_stats = profiler.Stats();
+    std::cout << "[profiler] samples=" << prof_stats.samples
+              << " dropped=" << prof_stats.dropped << '\n';
+    if (!profiler.WriteFolded(options.profile_out)) {
+      std::cerr << "failed to write folded stacks to " << options.profile_out << '\n';
     }
   }
 
@@ -0,0 +1,355 @@
+#include "profiler.h"
+
+#include <cxxabi.h>
+#include <dlfcn.h>
+#include <sys/syscall.h>
+#include <sys/time.h>
+#include <sys/uio.h>
+#include <ucontext.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <unordered_map>
+#include <vector>
+
+namespace signal_prof {
+
+namespace {
+
+// 帧指针链只在 [sp, sp + kMaxStackSpan) 范围内追踪，越界即停止。这只是合理性上界：
+// 范围内仍可能有未映射的页（例如 libc 把 rbp 当通用寄存器用时），读帧要走 ReadFrame。
+constexpr std::uintptr_t kMaxStackSpan = 8u << 20;
+// 按 4 KiB 记录“已验证可读”的页；页更大的系统上，4 KiB 对齐的块同样落在一个页内。
+constexpr std::uintptr_t kVerifyPageSize = 4096;
+
+/*
+ * 在 SIGPROF handler 里读一帧 [fp] / [fp + 8]，读不到返回 false 而不是崩溃。
+ * - 用 process_vm_readv 读自己的地址空间：目标页未映射时系统调用返回错误，不会触发 SIGSEGV。
+ * - 读成功后把该页记进 verified_page，同一页里的后续帧直接解引用，
+ *   一次回溯通常只需 1～3 次系统调用（本线程栈上的页在 handler 执行期间不会被回收）。
+ */
+bool ReadFrame(std::uintptr_t fp, std::uintptr_t& next_fp, std::uintptr_t& return_addr,
+               std::uintptr_t& verified_page) {
+  const std::uintptr_t page = fp & ~(kVerifyPageSize - 1);
+  const bool in_one_page = fp - page <= kVerifyPageSize - 2 * sizeof(std::uintptr_t);
+  if (in_one_page && page == verified_page) {
+    const auto* frame = reinterpret_cast<const std::uintptr_t*>(fp);
+    next_fp = frame[0];
+    return_addr = frame[1];
+    return true;
+  }
+
+  std::uintptr_t frame[2] = {};
+  iovec local{frame, sizeof(frame)};
+  iovec remote{reinterpret_cast<void*>(fp), sizeof(frame)};
+  if (::process_vm_readv(::getpid(), &local, 1, &remote, 1, 0) !=
+      static_cast<ssize_t>(sizeof(frame))) {
+    return false;
+  }
+  if (in_one_page) {
+    verified_page = page;
+  }
+  next_fp = frame[0];
+  return_addr = frame[1];
+  return true;
+}
+
+bool ReadMachineContext(void* ucontext, std::uintptr_t& pc, std::uintptr_t& fp,
+                        std::uintptr_t& sp) {
+  const auto* uc = static_cast<const ucontext_t*>(ucontext);
+#if defined(__x86_64__)
+  pc = static_cast<std::uintptr_t>(uc->uc_mcontext.gregs[REG_RIP]);
+  fp = static_cast<std::uintptr_t>(uc->uc_mcontext.gregs[REG_RBP]);
+  sp = static_cast<std::uintptr_t>(uc->uc_mcontext.gregs[REG_RSP]);
+  return true;
+#elif defined(__aarch64__)
+  pc = static_cast<std::uintptr_t>(uc->uc_mcontext.pc);
+  fp = static_cast<std::uintptr_t>(uc->uc_mcontext.regs[29]);
+  sp = static_cast<std::uintptr_t>(uc->uc_mcontext.sp);
+  return true;
+#else
+  (void)uc;
+  (void)pc;
+  (void)fp;
+  (void)sp;
+  return false;
+#endif
+}
+
+std::string Demangle(const char* name) {
+  int status = 0;
+  char* demangled = abi::__cxa_demangle(name, nullptr, nullptr, &status);
+  if (status != 0 || demangled == nullptr) {
+    return name;
+  }
+  std::string result(demangled);
+  std::free(demangled);
+  return result;
+}
+
+std::string Symbolize(std::uintptr_t pc) {
+  Dl_info info{};
+  if (::dladdr(reinterpret_cast<void*>(pc), &info) == 0) {
+    char buf[32];
+    std::snprintf(buf, sizeof(buf), "0x%zx", static_cast<std::size_t>(pc));
+    return buf;
+  }
+  if (info.dli_sname != nullptr) {
+    return Demangle(info.dli_sname);
+  }
+
+  // 没有动态符号（如匿名命名空间里的函数）时输出 "模块+偏移"，可再交给 addr2line。
+  const char* module = info.dli_fname != nullptr ? info.dli_fname : "?";
+  const char* slash = std::strrchr(module, '/');
+  char buf[64];
+  std::snprintf(buf, sizeof(buf), "+0x%zx",
+                static_cast<std::size_t>(pc - reinterpret_cast<std::uintptr_t>(info.dli_fbase)));
+  return std::string(slash != nullptr ? slash + 1 : module) + buf;
+}
+
+}  // namespace
+
+Profiler& Profiler::Instance() {
+  // 故意不释放：进程退出时仍可能有在途的 SIGPROF。
+  static Profiler* instance = new Profiler();
+  return *instance;
+}
+
+bool Profiler::Start(int hz, TimerMode mode, std::string& error, int sample_capacity) {
+  if (running()) {
+    error = "profiler already running";
+    return false;
+  }
+  if (hz <= 0 || hz > 100000) {
+    error = "hz must be in [1, 100000]";
+    return false;
+  }
+  if (sample_capacity <= 0) {
+    error = "sample capacity must be positive";
+    return false;
+  }
+
+  // 缓冲区在定时器启动前一次性分配好，handler 中只做下标抢占。
+  if (capacity_ != sample_capacity) {
+    samples_.reset(new Sample[sample_capacity]);
+    capacity_ = sample_capacity;
+  }
+  for (int i = 0; i < capacity_; ++i) {
+    samples_[i].ready.store(false, std::memory_order_relaxed);
+  }
+  next_.store(0, std::memory_order_relaxed);
+  dropped_.store(0, std::memory_order_relaxed);
+  thread_timer_count_.store(0, std::memory_order_relaxed);
+  mode_ = mode;
+  hz_ = hz;
+
+  struct sigaction action {};
+  action.sa_sigaction = &Profiler::OnSigprof;
+  action.sa_flags = SA_SIGINFO | SA_RESTART;
+  sigemptyset(&action.sa_mask);
+  if (::sigaction(SIGPROF, &action, &previous_action_) != 0) {
+    error = std::string("sigaction(SIGPROF): ") + std::strerror(errno);
+    return false;
+  }
+  running_.store(true, std::memory_order_release);
+
+  if (mode_ == TimerMode::kProcess) {
+    // 周期拆成秒 + 余数：tv_usec 必须小于 1000000，低频（例如 1 Hz）时不能整段放进去。
+    const long period_us = 1000000L / hz;
+    itimerval timer{};
+    timer.it_interval.tv_sec = period_us / 1000000L;
+    timer.it_interval.tv_usec = period_us % 1000000L;
+    timer.it_value = timer.it_interval;
+    if (::setitimer(ITIMER_PROF, &timer, nullptr) != 0) {
+      error = std::string("setitimer(ITIMER_PROF): ") + std::strerror(errno);
+      Stop();
+      return false;
+    }
+    return true;
+  }
+
+  // kThreadCpu：调用 Start 的线程自动注册，其余线程需自行调用 RegisterCurrentThread。
+  return RegisterCurrentThread(error);
+}
+
+bool Profiler::RegisterCurrentThread(std::string& error) {
+  if (!running() || mode_ != TimerMode::kThreadCpu) {
+    return true;
+  }
+
+  const int index = thread_timer_count_.load(std::memory_order_relaxed);
+  if (index >= kMaxThreadTimers) {
+    error = "too many profiled threads";
+    return false;
+  }
+
+  sigevent event{};
+  event.sigev_notify = SIGEV_THREAD_ID;
+  event.sigev_signo = SIGPROF;
+  event._sigev_un._tid = static_cast<pid_t>(::syscall(SYS_gettid));
+
+  timer_t timer{};
+  if (::timer_create(CLOCK_THREAD_CPUTIME_ID, &event, &timer) != 0) {
+    error = std::string("timer_create: ") + std::strerror(errno);
+    return false;
+  }
+
+  const long period_ns = 1000000000L / hz_;
+  itimerspec spec{};
+  spec.it_interval.tv_sec = period_ns / 1000000000L;
+  spec.it_interval.tv_nsec = period_ns % 1000000000L;
+  spec.it_value = spec.it_interval;
+  if (::timer_settime(timer, 0, &spec, nullptr) != 0) {
+    error = std::string("timer_settime: ") + std::strerror(errno);
+    ::timer_delete(timer);
+    return false;
+  }
+
+  // 注册只发生在线程启动阶段，用 CAS 领取下标即可，无需加锁。
+  int slot = thread_timer_count_.load(std::memory_order_relaxed);
+  while (slot < kMaxThreadTimers &&
+         !thread_timer_count_.compare_exchange_weak(slot, slot + 1,
+                                                    std::memory_order_acq_rel)) {
+  }
+  if (slot >= kMaxThreadTimers) {
+    ::timer_delete(timer);
+    error = "too many profiled threads";
+    return false;
+  }
+  thread_timers_[slot] = timer;
+  return true;
+}
+
+void Profiler::Stop() {
+  if (!running()) {
+    return;
+  }
+
+  if (mode_ == TimerMode::kProcess) {
+    itimerval disarm{};
+    ::setitimer(ITIMER_PROF, &disarm, nullptr);
+  } else {
+    const int count = thread_timer_count_.exchange(0, std::memory_order_acq_rel);
+    for (int i = 0; i < count && i < kMaxThreadTimers; ++i) {
+      ::timer_delete(thread_timers_[i]);
+    }
+  }
+
+  running_.store(false, std::memory_order_release);
+  ::sigaction(SIGPROF, &previous_action_, nullptr);
+}
+
+ProfilerStats Profiler::Stats() const {
+  ProfilerStats stats;
+  const int used = next_.load(std::memory_order_acquire);
+  stats.samples = static_cast<std::uint64_t>(used < capacity_ ? used : capacity_);
+  stats.dropped = dropped_.load(std::memory_order_relaxed);
+  return stats;
+}
+
+void Profiler::OnSigprof(int /*sig*/, siginfo_t* /*info*/, void* ucontext) {
+  const int saved_errno = errno;
+  Instance().Capture(ucontext);
+  errno = saved_errno;
+}
+
+void Profiler::Capture(void* ucontext) {
+  if (!running_.load(std::memory_order_relaxed)) {
+    return;
+  }
+
+  const int index = next_.fetch_add(1, std::memory_order_relaxed);
+  if (index >= capacity_) {
+    next_.store(capacity_, std::memory_order_relaxed);
+    dropped_.fetch_add(1, std::memory_order_relaxed);
+    return;
+  }
+
+  Sample& sample = samples_[index];
+  std::uintptr_t pc = 0;
+  std::uintptr_t fp = 0;
+  std::uintptr_t sp = 0;
+  int depth = 0;
+
+  if (ReadMachineContext(ucontext, pc, fp, sp)) {
+    sample.pcs[depth++] = pc;
+    // 帧布局：[fp] = 上一帧 fp，[fp + 8] = 返回地址。要求 fp 单调递增且不越出栈范围。
+    std::uintptr_t verified_page = 0;
+    while (depth < kMaxFrames) {
+      if (fp < sp || fp - sp >= kMaxStackSpan || fp % sizeof(std::uintptr_t) != 0) {
+        break;
+      }
+      std::uintptr_t next_fp = 0;
+      std::uintptr_t return_addr = 0;
+      if (!ReadFrame(fp, next_fp, return_addr, verified_page) || return_addr == 0) {
+        break;
+      }
+      // 返回地址减 1 落回 call 指令内部，符号化时才会归到调用者而不是下一条语句。
+      sample.pcs[depth++] = return_addr - 1;
+      if (next_fp <= fp) {
+        break;
+      }
+      fp = next_fp;
+    }
+  }
+
+  sample.depth = depth;
+  sample.ready.store(true, std::memory_order_release);
+}
+
+void Profiler::WriteFolded(std::ostream& out) const {
+  const int used = static_cast<int>(Stats().samples);
+  std::map<std::vector<std::uintptr_t>, std::uint64_t> stacks;
+  for (int i = 0; i < used; ++i) {
+    const Sample& sample = samples_[i];
+    if (!sample.ready.load(std::memory_order_acquire) || sample.depth == 0) {
+      continue;
+    }
+    stacks[std::vector<std::uintptr_t>(sample.pcs, sample.pcs + sample.depth)] += 1;
+  }
+
+  std::unordered_map<std::uintptr_t, std::string> names;
+  std::map<std::string, std::uint64_t> folded;
+  for (const auto& entry : stacks) {
+    std::string line;
+    // folded 格式从根到叶，所以倒序拼接。
+    for (auto it = entry.first.rbegin(); it != entry.first.rend(); ++it) {
+      auto found = names.find(*it);
+      if (found == names.end()) {
+        found = names.emplace(*it, Symbolize(*it)).first;
+      }
+      if (!line.empty()) {
+        line += ';';
+      }
+      line += found->second;
+    }
+    folded[line] += entry.second;
+  }
+
+  for (const auto& entry : folded) {
+    out << entry.first << ' ' << entry.second << '\n';
+  }
+  out.flush();
+}
+
+bool Profiler::WriteFolded(const std::string& path) const {
+  if (path.empty()) {
+    WriteFolded(std::cout);
+    return static_cast<bool>(std::cout);
+  }
+
+  std::ofstream file(path, std::ios::trunc);
+  if (!file) {
+    return false;
+  }
+  WriteFolded(file);
+  return static_cast<bool>(file);
+}
+
+}  // namespace signal_prof
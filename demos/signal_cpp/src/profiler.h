@@ -0,0 +1,88 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <ostream>
+#include <string>
+
+#include <csignal>
+#include <ctime>
+
+namespace signal_prof {
+
+constexpr int kMaxFrames = 63;
+constexpr int kMaxThreadTimers = 128;
+constexpr int kDefaultSampleCapacity = 16384;
+
+enum class TimerMode {
+  // setitimer(ITIMER_PROF)：整个进程共享一个 CPU 时间定时器，信号投递给正在跑的线程。
+  kProcess,
+  // 每线程 timer_create(CLOCK_THREAD_CPUTIME_ID)：按各线程自己的 CPU 时间采样，更均匀。
+  kThreadCpu,
+};
+
+struct ProfilerStats {
+  std::uint64_t samples = 0;
+  // 预分配缓冲区写满后丢弃的样本数。
+  std::uint64_t dropped = 0;
+};
+
+/*
+ * SIGPROF 采样 profiler。
+ * - Start() 预分配样本缓冲区并安装 sigaction，之后才启动定时器。
+ * - handler 里只做三件事：抢占一个样本槽（原子 fetch_add）、按帧指针回溯、发布样本；
+ *   不分配内存、不加锁、不调用非 async-signal-safe 函数。
+ * - 符号化（dladdr + demangle）放在 WriteFolded() 里，在普通线程上下文执行。
+ * - 回溯依赖帧指针，目标代码需要 -fno-omit-frame-pointer；
+ *   可执行文件里的符号需要 -rdynamic 才能被 dladdr 找到。
+ */
+class Profiler final {
+ public:
+  static Profiler& Instance();
+
+  bool Start(int hz, TimerMode mode, std::string& error,
+             int sample_capacity = kDefaultSampleCapacity);
+
+  // kThreadCpu 模式下由每个需要采样的线程调用一次；其他情况是空操作。
+  bool RegisterCurrentThread(std::string& error);
+
+  void Stop();
+
+  bool running() const { return running_.load(std::memory_order_acquire); }
+  ProfilerStats Stats() const;
+
+  // 输出 flamegraph.pl / speedscope 可直接读取的 folded stacks，可在运行中调用。
+  void WriteFolded(std::ostream& out) const;
+  // path 为空时写 stdout；返回是否写入成功。
+  bool WriteFolded(const std::string& path) const;
+
+ private:
+  struct Sample {
+    std::atomic<bool> ready{false};
+    int depth = 0;
+    std::uintptr_t pcs[kMaxFrames] = {};
+  };
+
+  Profiler() = default;
+  Profiler(const Profiler&) = delete;
+  Profiler& operator=(const Profiler&) = delete;
+
+  static void OnSigprof(int sig, siginfo_t* info, void* ucontext);
+  void Capture(void* ucontext);
+
+  std::unique_ptr<Sample[]> samples_;
+  int capacity_ = 0;
+  std::atomic<int> next_{0};
+  std::atomic<std::uint64_t> dropped_{0};
+  std::atomic<bool> running_{false};
+
+  TimerMode mode_ = TimerMode::kProcess;
+  int hz_ = 0;
+  struct sigaction previous_action_ {};
+
+  timer_t thread_timers_[kMaxThreadTimers] = {};
+  std::atomic<int> thread_timer_count_{0};
+};
+
+}  // namespace signal_prof
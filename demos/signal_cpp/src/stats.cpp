@@ -0,0 +1,109 @@
+#include "stats.h"
+
+#include <fstream>
+#include <iostream>
+
+namespace signal_stats {
+
+std::uint64_t Snapshot::PercentileUpperBoundNs(double q) const {
+  std::uint64_t total = 0;
+  for (const auto count : latency_hist) {
+    total += count;
+  }
+  if (total == 0) {
+    return 0;
+  }
+
+  const auto target = static_cast<std::uint64_t>(q * static_cast<double>(total));
+  std::uint64_t seen = 0;
+  for (int i = 0; i < kLatencyBuckets; ++i) {
+    seen += latency_hist[i];
+    if (seen > target || seen == total) {
+      return std::uint64_t{1} << (i + 1);
+    }
+  }
+  return std::uint64_t{1} << kLatencyBuckets;
+}
+
+StatsRegistry& StatsRegistry::Instance() {
+  static StatsRegistry instance;
+  return instance;
+}
+
+ThreadStats* StatsRegistry::AcquireSlot() {
+  const int index = used_.fetch_add(1, std::memory_order_acq_rel);
+  if (index >= kMaxThreads) {
+    used_.store(kMaxThreads, std::memory_order_relaxed);
+    return nullptr;
+  }
+  return &slots_[index];
+}
+
+Snapshot StatsRegistry::Collect() const {
+  // 各字段分别 relaxed 读取，不同字段之间可能相差几次操作，作为运维快照足够。
+  Snapshot snapshot;
+  const int used = used_.load(std::memory_order_acquire);
+  snapshot.threads = used < kMaxThreads ? used : kMaxThreads;
+
+  for (int t = 0; t < snapshot.threads; ++t) {
+    const ThreadStats& slot = slots_[t];
+    const auto ops = slot.ops.load(std::memory_order_relaxed);
+    snapshot.ops_per_thread[t] = ops;
+    snapshot.ops += ops;
+    snapshot.latency_samples += slot.latency_samples.load(std::memory_order_relaxed);
+    snapshot.latency_sum_ns += slot.latency_sum_ns.load(std::memory_order_relaxed);
+
+    const auto max_ns = slot.latency_max_ns.load(std::memory_order_relaxed);
+    if (max_ns > snapshot.latency_max_ns) {
+      snapshot.latency_max_ns = max_ns;
+    }
+    for (int b = 0; b < kLatencyBuckets; ++b) {
+      snapshot.latency_hist[b] += slot.latency_hist[b].load(std::memory_order_relaxed);
+    }
+  }
+  return snapshot;
+}
+
+void WriteSnapshot(std::ostream& out, const Snapshot& snapshot) {
+  const std::uint64_t avg_ns =
+      snapshot.latency_samples == 0 ? 0 : snapshot.latency_sum_ns / snapshot.latency_samples;
+
+  out << "[stats] threads=" << snapshot.threads
+      << " ops=" << snapshot.ops
+      << " samples=" << snapshot.latency_samples
+      << " avg_ns=" << avg_ns
+      << " p50_ns<=" << snapshot.PercentileUpperBoundNs(0.50)
+      << " p99_ns<=" << snapshot.PercentileUpperBoundNs(0.99)
+      << " p999_ns<=" << snapshot.PercentileUpperBoundNs(0.999)
+      << " max_ns=" << snapshot.latency_max_ns << '\n';
+
+  for (int t = 0; t < snapshot.threads; ++t) {
+    out << "  thread[" << t << "] ops=" << snapshot.ops_per_thread[t] << '\n';
+  }
+
+  out << "  latency histogram (ns):\n";
+  for (int b = 0; b < kLatencyBuckets; ++b) {
+    if (snapshot.latency_hist[b] == 0) {
+      continue;
+    }
+    out << "    [" << (std::uint64_t{1} << b) << ", "
+        << (std::uint64_t{1} << (b + 1)) << ") " << snapshot.latency_hist[b] << '\n';
+  }
+  out.flush();
+}
+
+bool DumpSnapshot(const std::string& path, const Snapshot& snapshot) {
+  if (path.empty()) {
+    WriteSnapshot(std::cout, snapshot);
+    return static_cast<bool>(std::cout);
+  }
+
+  std::ofstream file(path, std::ios::app);
+  if (!file) {
+    return false;
+  }
+  WriteSnapshot(file, snapshot);
+  return static_cast<bool>(file);
+}
+
+}  // namespace signal_stats
@@ -0,0 +1,108 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+#include <string>
+
+namespace signal_stats {
+
+constexpr std::size_t kCacheLine = 64;
+constexpr int kMaxThreads = 64;
+// 第 i 个桶统计 [2^i, 2^(i+1)) ns 的延迟，最后一个桶兜底更大的值。
+constexpr int kLatencyBuckets = 40;
+// 每 kLatencySampleEvery 次操作计时一次：clock_gettime 本身约 20~50ns，逐次计时会吃掉预算。
+constexpr std::uint64_t kLatencySampleEvery = 8;
+
+/*
+ * 每个线程独占一份计数槽：
+ * - alignas(kCacheLine) 保证不同线程的槽不会落在同一 cache line（避免 false sharing）。
+ * - 只有拥有者线程写入，写法是 relaxed load + relaxed store，不产生 lock 前缀的 RMW。
+ * - collector 线程只做 relaxed load，不加锁、不打断 worker。
+ */
+struct alignas(kCacheLine) ThreadStats {
+  std::atomic<std::uint64_t> ops{0};
+  std::atomic<std::uint64_t> latency_samples{0};
+  std::atomic<std::uint64_t> latency_sum_ns{0};
+  std::atomic<std::uint64_t> latency_max_ns{0};
+  std::array<std::atomic<std::uint64_t>, kLatencyBuckets> latency_hist{};
+
+  // 返回本次操作是否需要计时（按 kLatencySampleEvery 采样）。
+  bool CountOp() {
+    const std::uint64_t next = ops.load(std::memory_order_relaxed) + 1;
+    ops.store(next, std::memory_order_relaxed);
+    return next % kLatencySampleEvery == 0;
+  }
+
+  void RecordLatency(std::uint64_t latency_ns) {
+    Bump(latency_samples, 1);
+    Bump(latency_sum_ns, latency_ns);
+    Bump(latency_hist[BucketOf(latency_ns)], 1);
+    if (latency_ns > latency_max_ns.load(std::memory_order_relaxed)) {
+      latency_max_ns.store(latency_ns, std::memory_order_relaxed);
+    }
+  }
+
+  static int BucketOf(std::uint64_t latency_ns) {
+    if (latency_ns == 0) {
+      return 0;
+    }
+    const int bucket = 63 - __builtin_clzll(latency_ns);
+    return bucket < kLatencyBuckets ? bucket : kLatencyBuckets - 1;
+  }
+
+ private:
+  static void Bump(std::atomic<std::uint64_t>& cell, std::uint64_t delta) {
+    // 单写者：读-改-写不需要原子 RMW，只需保证 collector 读到的是完整的 64 位值。
+    cell.store(cell.load(std::memory_order_relaxed) + delta,
+               std::memory_order_relaxed);
+  }
+};
+
+static_assert(sizeof(ThreadStats) % kCacheLine == 0,
+              "ThreadStats must occupy whole cache lines");
+
+struct Snapshot {
+  int threads = 0;
+  std::uint64_t ops = 0;
+  std::uint64_t latency_samples = 0;
+  std::uint64_t latency_sum_ns = 0;
+  std::uint64_t latency_max_ns = 0;
+  std::array<std::uint64_t, kLatencyBuckets> latency_hist{};
+  std::array<std::uint64_t, kMaxThreads> ops_per_thread{};
+
+  // 返回包含第 q 分位的桶上界（ns），q 取值 [0, 1]。
+  std::uint64_t PercentileUpperBoundNs(double q) const;
+};
+
+/*
+ * 进程级的统计槽注册表。
+ * - 槽位在静态存储区预先分配好，worker 启动时领取一个槽（只在启动时有一次原子操作）。
+ * - Collect() 遍历已领取的槽并汇总，可以在任意普通线程（例如主循环）里调用。
+ */
+class StatsRegistry final {
+ public:
+  static StatsRegistry& Instance();
+
+  // 槽位耗尽时返回 nullptr，调用方应退化为“不统计”。
+  ThreadStats* AcquireSlot();
+
+  Snapshot Collect() const;
+
+ private:
+  StatsRegistry() = default;
+  StatsRegistry(const StatsRegistry&) = delete;
+  StatsRegistry& operator=(const StatsRegistry&) = delete;
+
+  std::array<ThreadStats, kMaxThreads> slots_{};
+  std::atomic<int> used_{0};
+};
+
+void WriteSnapshot(std::ostream& out, const Snapshot& snapshot);
+
+// path 为空时写 stdout，否则以追加方式写入文件；返回是否写入成功。
+bool DumpSnapshot(const std::string& path, const Snapshot& snapshot);
+
+}  // namespace signal_stats
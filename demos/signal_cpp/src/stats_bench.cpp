@@ -0,0 +1,97 @@
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "stats.h"
+#include "worker.h"
+
+namespace {
+
+constexpr int kRounds = 3;
+// always-on 统计的开销预算（相对无统计时的吞吐）。
+constexpr double kOverheadBudgetPercent = 1.0;
+
+struct BenchConfig {
+  int threads = 4;
+  double seconds = 1.0;
+};
+
+/*
+ * 在 threads 个线程上跑固定时长的 WorkerLoop，返回总吞吐（ops/s）。
+ * with_stats=false 时 worker 不计时、不写计数槽，作为基线。
+ */
+double MeasureThroughput(const BenchConfig& cfg, bool with_stats) {
+  std::atomic<bool> stop{false};
+  std::vector<std::uint64_t> done(cfg.threads, 0);
+  std::vector<std::thread> threads;
+  threads.reserve(cfg.threads);
+
+  const auto begin = std::chrono::steady_clock::now();
+  for (int i = 0; i < cfg.threads; ++i) {
+    threads.emplace_back([&, i]() {
+      signal_stats::ThreadStats* slot =
+          with_stats ? signal_stats::StatsRegistry::Instance().AcquireSlot() : nullptr;
+      done[i] = signal_stats::WorkerLoop(stop, slot);
+    });
+  }
+
+  std::this_thread::sleep_for(std::chrono::duration<double>(cfg.seconds));
+  stop.store(true, std::memory_order_relaxed);
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  const std::chrono::duration<double> elapsed =
+      std::chrono::steady_clock::now() - begin;
+
+  std::uint64_t total = 0;
+  for (const auto count : done) {
+    total += count;
+  }
+  return static_cast<double>(total) / elapsed.count();
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  BenchConfig cfg;
+  if (argc >= 2) {
+    cfg.threads = std::atoi(argv[1]);
+  }
+  if (argc >= 3) {
+    cfg.seconds = std::atof(argv[2]);
+  }
+  // 每轮都会领取新的计数槽，总槽数需覆盖 kRounds * threads。
+  if (cfg.threads <= 0 || cfg.threads * kRounds > signal_stats::kMaxThreads ||
+      cfg.seconds <= 0) {
+    std::cerr << "usage: " << argv[0] << " [threads (1.."
+              << signal_stats::kMaxThreads / kRounds << ")] [seconds]\n";
+    return 2;
+  }
+
+  // 交替测量，取各自最好的一轮，降低频率漂移/调度噪声的影响。
+  double best_off = 0;
+  double best_on = 0;
+  for (int round = 0; round < kRounds; ++round) {
+    best_off = std::max(best_off, MeasureThroughput(cfg, false));
+    best_on = std::max(best_on, MeasureThroughput(cfg, true));
+  }
+
+  const double overhead = (best_off - best_on) / best_off * 100.0;
+  std::cout << "threads=" << cfg.threads << " seconds=" << cfg.seconds << '\n'
+            << std::fixed << std::setprecision(0)
+            << "stats off : " << best_off << " ops/s\n"
+            << "stats on  : " << best_on << " ops/s\n"
+            << std::setprecision(2)
+            << "overhead  : " << overhead << "% (budget " << kOverheadBudgetPercent
+            << "%) " << (overhead <= kOverheadBudgetPercent ? "OK" : "OVER") << "\n\n";
+
+  signal_stats::WriteSnapshot(std::cout, signal_stats::StatsRegistry::Instance().Collect());
+  return 0;
+}
@@ -0,0 +1,434 @@
+#include "supervisor.h"
+
+#include <poll.h>
+#include <sys/mman.h>
+#include <sys/signalfd.h>
+#include <sys/time.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <csignal>
+#include <cstdint>
+#include <cstring>
+#include <ctime>
+#include <iomanip>
+#include <iostream>
+#include <new>
+#include <vector>
+
+#include "stats.h"
+#include "worker.h"
+
+namespace signal_supervisor {
+
+namespace {
+
+constexpr std::uint64_t kNsPerMs = 1000000ULL;
+constexpr std::uint64_t kReportIntervalNs = 1000 * kNsPerMs;
+// 运行超过这个时长才算“健康退出”，之后的重启不退避。
+constexpr std::uint64_t kHealthyUptimeNs = 1000 * kNsPerMs;
+constexpr std::uint64_t kInitialBackoffNs = 10 * kNsPerMs;
+constexpr std::uint64_t kMaxBackoffNs = 2000 * kNsPerMs;
+// 优雅退出超时后升级为 SIGKILL。
+constexpr std::uint64_t kDrainTimeoutNs = 5000 * kNsPerMs;
+
+// 放在 MAP_SHARED 匿名映射里，父子进程共同可见；每个槽只有当前 worker 一个写者。
+struct alignas(signal_stats::kCacheLine) WorkerSlot {
+  signal_stats::ThreadStats stats;
+  // worker 进入主循环前写入的 CLOCK_MONOTONIC 时间，父进程据此计算重启延迟。
+  std::atomic<std::uint64_t> ready_ns{0};
+};
+
+struct SlotState {
+  pid_t pid = -1;
+  std::uint64_t started_ns = 0;
+  std::uint64_t reaped_ns = 0;
+  std::uint64_t respawn_at_ns = 0;
+  std::uint64_t backoff_ns = 0;
+  bool awaiting_ready = false;
+};
+
+std::atomic<bool> g_child_stop{false};
+
+std::uint64_t NowNs() {
+  timespec ts{};
+  ::clock_gettime(CLOCK_MONOTONIC, &ts);
+  return static_cast<std::uint64_t>(ts.tv_sec) * 1000000000ULL +
+         static_cast<std::uint64_t>(ts.tv_nsec);
+}
+
+void ChildTermHandler(int /*sig*/) {
+  g_child_stop.store(true, std::memory_order_relaxed);
+}
+
+[[noreturn]] void RunChild(WorkerSlot& slot, int crash_after_ms, const sigset_t& blocked) {
+  // 子进程继承了父进程的信号掩码，先恢复默认处理再解除屏蔽。
+  std::signal(SIGCHLD, SIG_DFL);
+  std::signal(SIGINT, SIG_IGN);
+  std::signal(SIGQUIT, SIG_DFL);
+  std::signal(SIGTERM, ChildTermHandler);
+  ::sigprocmask(SIG_UNBLOCK, &blocked, nullptr);
+
+  if (crash_after_ms > 0) {
+    // SIGALRM 默认动作是终止进程，用来模拟 worker 意外死亡。
+    itimerval timer{};
+    timer.it_value.tv_sec = crash_after_ms / 1000;
+    timer.it_value.tv_usec = (crash_after_ms % 1000) * 1000;
+    ::setitimer(ITIMER_REAL, &timer, nullptr);
+  }
+
+  slot.ready_ns.store(NowNs(), std::memory_order_release);
+  signal_stats::WorkerLoop(g_child_stop, &slot.stats);
+  ::_exit(0);
+}
+
+class Supervisor final {
+ public:
+  Supervisor(const SupervisorConfig& config, WorkerSlot* slots)
+      : config_(config), slots_(slots), states_(config.workers) {}
+
+  int Run();
+
+ private:
+  bool Spawn(int index, std::uint64_t now);
+  void ReapAll(std::uint64_t now);
+  void RespawnDue(std::uint64_t now);
+  void CollectReadyLatencies();
+  void BeginDrain(std::uint64_t now);
+  void KillRemaining();
+  void Report(std::uint64_t now);
+  void PrintSummary(std::uint64_t now) const;
+  int LiveCount() const;
+  std::uint64_t TotalOps() const;
+  int PollTimeoutMs(std::uint64_t now) const;
+
+  const SupervisorConfig config_;
+  WorkerSlot* slots_;
+  std::vector<SlotState> states_;
+  sigset_t blocked_{};
+
+  bool draining_ = false;
+  std::uint64_t drain_deadline_ns_ = 0;
+  bool killed_ = false;
+
+  std::uint64_t start_ns_ = 0;
+  std::uint64_t next_report_ns_ = 0;
+  std::uint64_t last_report_ns_ = 0;
+  std::uint64_t last_report_ops_ = 0;
+
+  std::uint64_t restarts_ = 0;
+  std::uint64_t crashes_ = 0;
+  std::vector<std::uint64_t> respawn_latency_ns_;
+};
+
+bool Supervisor::Spawn(int index, std::uint64_t now) {
+  SlotState& state = states_[index];
+  WorkerSlot& slot = slots_[index];
+  slot.ready_ns.store(0, std::memory_order_relaxed);
+
+  const pid_t pid = ::fork();
+  if (pid < 0) {
+    std::cerr << "[supervisor] fork failed: " << std::strerror(errno) << '\n';
+    state.respawn_at_ns = now + kInitialBackoffNs;
+    return false;
+  }
+  if (pid == 0) {
+    RunChild(slot, config_.crash_after_ms, blocked_);
+  }
+
+  state.pid = pid;
+  state.started_ns = now;
+  state.respawn_at_ns = 0;
+  return true;
+}
+
+void Supervisor::ReapAll(std::uint64_t now) {
+  // 标准信号不排队：一次 SIGCHLD 可能对应多个子进程退出，必须循环 WNOHANG 直到没有可回收的。
+  while (true) {
+    int status = 0;
+    const pid_t pid = ::waitpid(-1, &status, WNOHANG);
+    if (pid <= 0) {
+      break;
+    }
+
+    for (std::size_t i = 0; i < states_.size(); ++i) {
+      SlotState& state = states_[i];
+      if (state.pid != pid) {
+        continue;
+      }
+
+      state.pid = -1;
+      state.reaped_ns = now;
+      const bool clean = WIFEXITED(status) && WEXITSTATUS(status) == 0;
+      if (!clean) {
+        ++crashes_;
+      }
+      if (draining_) {
+        break;
+      }
+
+      // 活得够久的 worker 立即重启；短时间内反复挂掉的按指数退避，避免 fork 风暴。
+      if (now - state.started_ns >= kHealthyUptimeNs) {
+        state.backoff_ns = 0;
+      } else if (state.backoff_ns == 0) {
+        state.backoff_ns = kInitialBackoffNs;
+      } else {
+        state.backoff_ns = std::min(state.backoff_ns * 2, kMaxBackoffNs);
+      }
+      state.respawn_at_ns = now + state.backoff_ns;
+      state.awaiting_ready = true;
+      break;
+    }
+  }
+}
+
+void Supervisor::RespawnDue(std::uint64_t now) {
+  if (draining_) {
+    return;
+  }
+  for (std::size_t i = 0; i < states_.size(); ++i) {
+    SlotState& state = states_[i];
+    if (state.pid < 0 && state.respawn_at_ns != 0 && state.respawn_at_ns <= now) {
+      if (Spawn(static_cast<int>(i), now)) {
+        ++restarts_;
+      }
+    }
+  }
+}
+
+void Supervisor::CollectReadyLatencies() {
+  for (std::size_t i = 0; i < states_.size(); ++i) {
+    SlotState& state = states_[i];
+    if (!state.awaiting_ready || state.pid < 0) {
+      continue;
+    }
+    const std::uint64_t ready = slots_[i].ready_ns.load(std::memory_order_acquire);
+    if (ready == 0) {
+      continue;
+    }
+    // 从父进程回收旧 worker 到新 worker 进入主循环（含退避等待）。
+    respawn_latency_ns_.push_back(ready - state.reaped_ns);
+    state.awaiting_ready = false;
+  }
+}
+
+void Supervisor::BeginDrain(std::uint64_t now) {
+  if (draining_) {
+    return;
+  }
+  draining_ = true;
+  drain_deadline_ns_ = now + kDrainTimeoutNs;
+  std::cout << "[supervisor] draining " << LiveCount() << " worker(s)\n";
+  for (const auto& state : states_) {
+    if (state.pid > 0) {
+      ::kill(state.pid, SIGTERM);
+    }
+  }
+}
+
+void Supervisor::KillRemaining() {
+  for (const auto& state : states_) {
+    if (state.pid > 0) {
+      ::kill(state.pid, SIGKILL);
+    }
+  }
+  killed_ = true;
+}
+
+int Supervisor::LiveCount() const {
+  int live = 0;
+  for (const auto& state : states_) {
+    if (state.pid > 0) {
+      ++live;
+    }
+  }
+  return live;
+}
+
+std::uint64_t Supervisor::TotalOps() const {
+  std::uint64_t total = 0;
+  for (std::size_t i = 0; i < states_.size(); ++i) {
+    total += slots_[i].stats.ops.load(std::memory_order_relaxed);
+  }
+  return total;
+}
+
+void Supervisor::Report(std::uint64_t now) {
+  if (now < next_report_ns_) {
+    return;
+  }
+  const std::uint64_t ops = TotalOps();
+  const double seconds = static_cast<double>(now - last_report_ns_) / 1e9;
+  std::cout << std::fixed << std::setprecision(1)
+            << "[supervisor] t=" << static_cast<double>(now - start_ns_) / 1e9 << "s"
+            << " live=" << LiveCount()
+            << " ops/s=" << std::setprecision(0)
+            << static_cast<double>(ops - last_report_ops_) / seconds
+            << " crashes=" << crashes_ << " restarts=" << restarts_ << '\n';
+  last_report_ns_ = now;
+  last_report_ops_ = ops;
+  next_report_ns_ = now + kReportIntervalNs;
+}
+
+void Supervisor::PrintSummary(std::uint64_t now) const {
+  const double seconds = static_cast<double>(now - start_ns_) / 1e9;
+  std::cout << std::fixed << std::setprecision(0)
+            << "[supervisor] summary: workers=" << config_.workers
+            << " total_ops=" << TotalOps()
+            << " avg_ops/s=" << static_cast<double>(TotalOps()) / seconds
+            << " crashes=" << crashes_ << " restarts=" << restarts_ << '\n';
+
+  if (respawn_latency_ns_.empty()) {
+    return;
+  }
+  std::vector<std::uint64_t> sorted = respawn_latency_ns_;
+  std::sort(sorted.begin(), sorted.end());
+  std::uint64_t sum = 0;
+  for (const auto value : sorted) {
+    sum += value;
+  }
+  const auto us = [](std::uint64_t ns) { return static_cast<double>(ns) / 1000.0; };
+  std::cout << std::setprecision(1)
+            << "[supervisor] respawn latency (reap -> worker ready, incl. backoff): n="
+            << sorted.size()
+            << " min=" << us(sorted.front()) << "us"
+            << " avg=" << us(sum / sorted.size()) << "us"
+            << " p99=" << us(sorted[(sorted.size() - 1) * 99 / 100]) << "us"
+            << " max=" << us(sorted.back()) << "us\n";
+}
+
+int Supervisor::PollTimeoutMs(std::uint64_t now) const {
+  std::uint64_t wake = next_report_ns_;
+  for (const auto& state : states_) {
+    if (!draining_ && state.pid < 0 && state.respawn_at_ns != 0) {
+      wake = std::min(wake, state.respawn_at_ns);
+    }
+  }
+  if (draining_) {
+    wake = std::min(wake, drain_deadline_ns_);
+  }
+  if (wake <= now) {
+    return 0;
+  }
+  // 向上取整，避免在截止时间前反复 0ms 唤醒。
+  return static_cast<int>((wake - now + kNsPerMs - 1) / kNsPerMs);
+}
+
+int Supervisor::Run() {
+  sigemptyset(&blocked_);
+  sigaddset(&blocked_, SIGCHLD);
+  sigaddset(&blocked_, SIGTERM);
+  sigaddset(&blocked_, SIGINT);
+  sigaddset(&blocked_, SIGQUIT);
+  if (::sigprocmask(SIG_BLOCK, &blocked_, nullptr) != 0) {
+    std::cerr << "[supervisor] sigprocmask: " << std::strerror(errno) << '\n';
+    return 1;
+  }
+
+  const int sfd = ::signalfd(-1, &blocked_, SFD_NONBLOCK | SFD_CLOEXEC);
+  if (sfd < 0) {
+    std::cerr << "[supervisor] signalfd: " << std::strerror(errno) << '\n';
+    return 1;
+  }
+
+  start_ns_ = NowNs();
+  last_report_ns_ = start_ns_;
+  next_report_ns_ = start_ns_ + kReportIntervalNs;
+  const std::uint64_t run_deadline_ns =
+      config_.run_seconds > 0
+          ? start_ns_ + static_cast<std::uint64_t>(config_.run_seconds * 1e9)
+          : 0;
+
+  std::cout << "[supervisor] PID=" << ::getpid() << " workers=" << config_.workers
+            << " crash_after_ms=" << config_.crash_after_ms << '\n';
+  for (int i = 0; i < config_.workers; ++i) {
+    Spawn(i, start_ns_);
+  }
+
+  bool failed = false;
+  while (true) {
+    pollfd pfd{sfd, POLLIN, 0};
+    const int ready = ::poll(&pfd, 1, PollTimeoutMs(NowNs()));
+    if (ready < 0 && errno != EINTR) {
+      std::cerr << "[supervisor] poll: " << std::strerror(errno) << '\n';
+      // 事件循环没法继续了：不能把 worker 留成孤儿，也不能让调用方以为是正常结束。
+      // 已经等不到 SIGCHLD，直接 SIGKILL 并阻塞回收。
+      BeginDrain(NowNs());
+      KillRemaining();
+      for (auto& state : states_) {
+        if (state.pid > 0) {
+          ::waitpid(state.pid, nullptr, 0);
+          state.pid = -1;
+        }
+      }
+      failed = true;
+      break;
+    }
+
+    bool child_event = false;
+    bool stop_requested = false;
+    signalfd_siginfo info{};
+    while (::read(sfd, &info, sizeof(info)) == static_cast<ssize_t>(sizeof(info))) {
+      if (static_cast<int>(info.ssi_signo) == SIGCHLD) {
+        child_event = true;
+      } else {
+        stop_requested = true;
+      }
+    }
+
+    const std::uint64_t now = NowNs();
+    if (child_event) {
+      ReapAll(now);
+    }
+    if (stop_requested || (run_deadline_ns != 0 && now >= run_deadline_ns)) {
+      BeginDrain(now);
+    }
+    RespawnDue(now);
+    CollectReadyLatencies();
+    Report(now);
+
+    if (draining_) {
+      if (LiveCount() == 0) {
+        break;
+      }
+      if (!killed_ && now >= drain_deadline_ns_) {
+        std::cout << "[supervisor] drain timeout, sending SIGKILL\n";
+        KillRemaining();
+      }
+    }
+  }
+
+  PrintSummary(NowNs());
+  ::close(sfd);
+  return failed ? 1 : 0;
+}
+
+}  // namespace
+
+int RunSupervisor(const SupervisorConfig& config) {
+  if (config.workers <= 0) {
+    std::cerr << "[supervisor] workers must be positive\n";
+    return 2;
+  }
+
+  const std::size_t bytes = sizeof(WorkerSlot) * static_cast<std::size_t>(config.workers);
+  void* shared = ::mmap(nullptr, bytes, PROT_READ | PROT_WRITE,
+                        MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+  if (shared == MAP_FAILED) {
+    std::cerr << "[supervisor] mmap: " << std::strerror(errno) << '\n';
+    return 1;
+  }
+  auto* slots = static_cast<WorkerSlot*>(shared);
+  for (int i = 0; i < config.workers; ++i) {
+    new (&slots[i]) WorkerSlot();
+  }
+
+  const int rc = Supervisor(config, slots).Run();
+  ::munmap(shared, bytes);
+  return rc;
+}
+
+}  // namespace signal_supervisor
@@ -0,0 +1,25 @@
+#pragma once
+
+namespace signal_supervisor {
+
+struct SupervisorConfig {
+  // 常驻 worker 进程数。
+  int workers = 4;
+  // >0 时每个 worker 运行这么久后被 SIGALRM 杀死，用来模拟崩溃、压测重启路径。
+  int crash_after_ms = 0;
+  // >0 时运行这么久后自动进入优雅退出（便于脚本化测量）；0 表示等待 SIGTERM/SIGINT。
+  double run_seconds = 0;
+};
+
+/*
+ * prefork 监督者：
+ * - 父进程屏蔽 SIGCHLD/SIGTERM/SIGINT/SIGQUIT，统一从 signalfd 读取，主循环里没有异步 handler。
+ * - SIGCHLD 可能合并，所以每次都用 waitpid(WNOHANG) 循环批量回收，直到没有可回收的子进程。
+ * - 崩溃的 worker 按槽位重启：运行足够久的立即重启，短时间内反复崩溃的指数退避。
+ * - 收到 SIGTERM/SIGINT 时停止重启并把 SIGTERM 转发给所有 worker，等待它们排空退出。
+ * worker 是内置的 CPU 密集任务（signal_stats::WorkerLoop），吞吐通过共享内存里的计数槽汇总。
+ * 返回值作为进程退出码。
+ */
+int RunSupervisor(const SupervisorConfig& config);
+
+}  // namespace signal_supervisor
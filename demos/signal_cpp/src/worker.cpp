@@ -0,0 +1,54 @@
+#include "worker.h"
+
+#include <ctime>
+
+namespace signal_stats {
+
+namespace {
+
+constexpr int kMixRoundsPerUnit = 2048;
+
+// 每个 worker 退出时写一次结果，防止整个计算循环被当作无副作用代码优化掉。
+std::atomic<std::uint64_t> g_sink{0};
+
+std::uint64_t NowNs() {
+  timespec ts{};
+  ::clock_gettime(CLOCK_MONOTONIC, &ts);
+  return static_cast<std::uint64_t>(ts.tv_sec) * 1000000000ULL +
+         static_cast<std::uint64_t>(ts.tv_nsec);
+}
+
+}  // namespace
+
+std::uint64_t RunWorkUnit(std::uint64_t seed) {
+  std::uint64_t state = seed | 1;
+  for (int i = 0; i < kMixRoundsPerUnit; ++i) {
+    // xorshift64* 的一轮，每轮依赖上一轮结果，编译器无法把循环折叠掉。
+    state ^= state >> 12;
+    state ^= state << 25;
+    state ^= state >> 27;
+    state *= 0x2545F4914F6CDD1DULL;
+  }
+  return state;
+}
+
+std::uint64_t WorkerLoop(const std::atomic<bool>& stop, ThreadStats* stats) {
+  std::uint64_t seed = reinterpret_cast<std::uintptr_t>(&seed);
+  std::uint64_t done = 0;
+
+  while (!stop.load(std::memory_order_relaxed)) {
+    if (stats != nullptr && stats->CountOp()) {
+      const std::uint64_t begin = NowNs();
+      seed = RunWorkUnit(seed);
+      stats->RecordLatency(NowNs() - begin);
+    } else {
+      seed = RunWorkUnit(seed);
+    }
+    ++done;
+  }
+
+  g_sink.store(seed, std::memory_order_relaxed);
+  return done;
+}
+
+}  // namespace signal_stats
@@ -0,0 +1,21 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+
+#include "stats.h"
+
+namespace signal_stats {
+
+// 一次“请求”的 CPU 负载：对 64 位状态做固定轮数的混合运算，耗时约数微秒。
+std::uint64_t RunWorkUnit(std::uint64_t seed);
+
+/*
+ * worker 主循环：反复执行 RunWorkUnit 直到 stop 置位。
+ * - stats 为 nullptr 时完全不计时、不统计（用于测量基线吞吐）。
+ * - 否则每次操作都计数，延迟按 kLatencySampleEvery 采样计时。
+ * - 返回完成的请求数，便于 benchmark 在不依赖统计槽的情况下计算吞吐。
+ */
+std::uint64_t WorkerLoop(const std::atomic<bool>& stop, ThreadStats* stats);
+
+}  // namespace signal_stats
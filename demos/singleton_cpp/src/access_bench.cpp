@@ -0,0 +1,197 @@
+#include "singleton_strategies.h"
+
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <ctime>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+constexpr std::uint64_t kCallsPerThread = 20000000;
+constexpr int kFirstTouchRuns = 9;
+
+using Clock = std::chrono::steady_clock;
+
+// 让编译器认为指针被“使用”且内存可能被改写，强制每次循环都重新走 Instance()。
+template <typename T>
+inline void DoNotOptimize(T* ptr) {
+  asm volatile("" : : "r"(ptr) : "memory");
+}
+
+struct Strategy {
+  const char* name;
+  // 在当前线程上连续访问 calls 次，返回耗时（ns）。
+  std::uint64_t (*access_loop)(std::uint64_t calls);
+  // 首次访问（触发初始化）的耗时（ns）。
+  std::uint64_t (*first_touch)();
+};
+
+// 线程自身的 CPU 时间：线程数超过核数时，不把等待调度的时间算进访问成本。
+std::uint64_t ThreadCpuNs() {
+  timespec ts{};
+  ::clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+  return static_cast<std::uint64_t>(ts.tv_sec) * 1000000000ULL +
+         static_cast<std::uint64_t>(ts.tv_nsec);
+}
+
+template <typename Singleton>
+std::uint64_t AccessLoop(std::uint64_t calls) {
+  const std::uint64_t begin = ThreadCpuNs();
+  for (std::uint64_t i = 0; i < calls; ++i) {
+    DoNotOptimize(&Singleton::Instance().payload);
+  }
+  return ThreadCpuNs() - begin;
+}
+
+template <typename Singleton>
+std::uint64_t FirstTouch() {
+  const auto begin = Clock::now();
+  DoNotOptimize(&Singleton::Instance().payload);
+  return static_cast<std::uint64_t>(
+      std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - begin).count());
+}
+
+// 空操作对照：首次访问数据里包含的计时本身开销。
+std::uint64_t EmptyTouch() {
+  const auto begin = Clock::now();
+  DoNotOptimize(&kCallsPerThread);
+  return static_cast<std::uint64_t>(
+      std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - begin).count());
+}
+
+template <typename Singleton>
+constexpr Strategy MakeStrategy(const char* name) {
+  return Strategy{name, &AccessLoop<Singleton>, &FirstTouch<Singleton>};
+}
+
+const Strategy kStrategies[] = {
+    MakeStrategy<singleton_strategies::StaticLocalSingleton>("static local"),
+    MakeStrategy<singleton_strategies::CallOnceSingleton>("call_once"),
+    MakeStrategy<singleton_strategies::DoubleCheckedSingleton>("double-checked atomic"),
+    MakeStrategy<singleton_strategies::ThreadLocalCachedSingleton>("thread_local cached"),
+    MakeStrategy<singleton_strategies::ConstantInitSingleton>("constinit/constexpr"),
+};
+
+/*
+ * 首次访问成本只能在“还没初始化过”的进程里测：每次 fork 一个子进程测一次，
+ * 通过退出前写管道把结果带回父进程，取中位数。
+ */
+std::uint64_t MeasureFirstTouchNs(std::uint64_t (*first_touch)()) {
+  std::vector<std::uint64_t> runs;
+  for (int run = 0; run < kFirstTouchRuns; ++run) {
+    int fds[2];
+    if (::pipe(fds) != 0) {
+      return 0;
+    }
+    const pid_t pid = ::fork();
+    if (pid == 0) {
+      ::close(fds[0]);
+      const std::uint64_t ns = first_touch();
+      const ssize_t written = ::write(fds[1], &ns, sizeof(ns));
+      ::_exit(written == static_cast<ssize_t>(sizeof(ns)) ? 0 : 1);
+    }
+    ::close(fds[1]);
+    std::uint64_t ns = 0;
+    if (pid > 0 && ::read(fds[0], &ns, sizeof(ns)) == static_cast<ssize_t>(sizeof(ns))) {
+      runs.push_back(ns);
+    }
+    ::close(fds[0]);
+    if (pid > 0) {
+      ::waitpid(pid, nullptr, 0);
+    }
+  }
+  if (runs.empty()) {
+    return 0;
+  }
+  std::sort(runs.begin(), runs.end());
+  return runs[runs.size() / 2];
+}
+
+// 所有线程就绪后同时起跑，返回平均每次访问的 ns（按各线程 CPU 时间求和再平均）。
+double MeasureSteadyStateNs(const Strategy& strategy, int threads) {
+  std::atomic<int> ready{0};
+  std::atomic<bool> go{false};
+  std::vector<std::uint64_t> elapsed(threads, 0);
+  std::vector<std::thread> workers;
+  workers.reserve(threads);
+
+  for (int t = 0; t < threads; ++t) {
+    workers.emplace_back([&, t]() {
+      // 预热：完成初始化和 thread_local 首次绑定，不计入稳态。
+      strategy.access_loop(1000);
+      ready.fetch_add(1, std::memory_order_acq_rel);
+      while (!go.load(std::memory_order_acquire)) {
+        std::this_thread::yield();
+      }
+      elapsed[t] = strategy.access_loop(kCallsPerThread);
+    });
+  }
+  while (ready.load(std::memory_order_acquire) != threads) {
+    std::this_thread::yield();
+  }
+  go.store(true, std::memory_order_release);
+  for (auto& worker : workers) {
+    worker.join();
+  }
+
+  std::uint64_t total_ns = 0;
+  for (const auto ns : elapsed) {
+    total_ns += ns;
+  }
+  return static_cast<double>(total_ns) / (static_cast<double>(kCallsPerThread) * threads);
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  const unsigned hw = std::max(1u, std::thread::hardware_concurrency());
+  const int max_threads = argc >= 2 ? std::atoi(argv[1]) : static_cast<int>(std::min(hw, 8u));
+  if (max_threads <= 0) {
+    std::cerr << "usage: " << argv[0] << " [max_threads]\n";
+    return 2;
+  }
+
+  std::vector<int> thread_counts;
+  for (int t = 1; t < max_threads; t *= 2) {
+    thread_counts.push_back(t);
+  }
+  thread_counts.push_back(max_threads);
+
+  // 先在 fork 出的干净进程里测首次访问，再在本进程测稳态，避免本进程已初始化。
+  std::cout << "== first-touch init cost (median of " << kFirstTouchRuns
+            << " fresh processes) ==\n";
+  std::cout << "  " << std::left << std::setw(24) << "(timer overhead)"
+            << MeasureFirstTouchNs(&EmptyTouch) << " ns\n";
+  for (const auto& strategy : kStrategies) {
+    std::cout << "  " << std::left << std::setw(24) << strategy.name
+              << MeasureFirstTouchNs(strategy.first_touch) << " ns\n";
+  }
+
+  std::cout << "\n== steady-state cost per access (ns/call, "
+            << kCallsPerThread << " calls/thread) ==\n";
+  std::cout << "  " << std::left << std::setw(24) << "STRATEGY";
+  for (const int threads : thread_counts) {
+    std::cout << std::right << std::setw(10) << ("T=" + std::to_string(threads));
+  }
+  std::cout << '\n';
+
+  for (const auto& strategy : kStrategies) {
+    std::cout << "  " << std::left << std::setw(24) << strategy.name << std::right
+              << std::fixed << std::setprecision(3);
+    for (const int threads : thread_counts) {
+      std::cout << std::setw(10) << MeasureSteadyStateNs(strategy, threads);
+    }
+    std::cout << '\n';
+  }
+  return 0;
+}
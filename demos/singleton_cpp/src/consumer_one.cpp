@@ -1,5 +1,9 @@
+#include "so_metrics_api.h"
 #include "so_singleton_api.h"
 
+#include <list>
+#include <mutex>
+
 namespace {
 
 class LocalSingletonOne final {
@@ -9,10 +13,39 @@ class LocalSingletonOne final {
     return instance;
   }
 
+  // 记录最近的 exported_value，超出上限时丢弃最旧的；返回当前保存的个数。
+  std::size_t Remember(int value) {
+    std::lock_guard<std::mutex> lock(mu_);
+    history_.push_back(value);
+    if (history_.size() > kMaxHistory) {
+      history_.pop_front();
+    }
+    return history_.size();
+  }
+
  private:
+  static constexpr std::size_t kMaxHistory = 16;
+
   LocalSingletonOne() = default;
+
+  std::mutex mu_;
+  // 小对象（链表节点）从 owner 的进程级对象池分配，而不是各 so 自己走全局 new。
+  std::list<int, SoPoolAllocator<int>> history_;
+};
+
+// 句柄只在首次使用时注册一次；两个 consumer 注册同名 metric 拿到的是同一个句柄。
+struct ConsumerMetrics {
+  SoMetric* snapshots = so_metrics_register("consumer_snapshots_total", SO_METRIC_COUNTER);
+  SoMetric* last_value = so_metrics_register("consumer_last_exported_value", SO_METRIC_GAUGE);
+  SoMetric* one_values =
+      so_metrics_register("consumer_one_exported_value", SO_METRIC_HISTOGRAM);
 };
 
+ConsumerMetrics& Metrics() {
+  static ConsumerMetrics metrics;
+  return metrics;
+}
+
 }  // namespace
 
 extern "C" SINGLETON_DEMO_EXPORT ConsumerSnapshot consumer_one_snapshot() {
@@ -25,5 +58,46 @@ extern "C" SINGLETON_DEMO_EXPORT ConsumerSnapshot consumer_one_snapshot() {
   snapshot.exported_singleton_addr =
       reinterpret_cast<std::uintptr_t>(exported_instance);
   snapshot.exported_value = so_singleton_next();
+  snapshot.pooled_history_size =
+      LocalSingletonOne::Instance().Remember(snapshot.exported_value);
+
+  ConsumerMetrics& metrics = Metrics();
+  so_metrics::CounterAdd(metrics.snapshots);
+  so_metrics::GaugeSet(metrics.last_value, snapshot.exported_value);
+  so_metrics::HistogramObserve(metrics.one_values,
+                               static_cast<std::uint64_t>(snapshot.exported_value));
   return snapshot;
 }
+
+extern "C" SINGLETON_DEMO_EXPORT void consumer_one_record_metrics(int mode,
+                                                                  std::uint64_t iterations) {
+  static SoMetric* const records =
+      so_metrics_register("consumer_one_bench_records_total", SO_METRIC_COUNTER);
+  static SoMetric* const level =
+      so_metrics_register("consumer_one_bench_level", SO_METRIC_GAUGE);
+  static SoMetric* const sizes =
+      so_metrics_register("consumer_one_bench_size", SO_METRIC_HISTOGRAM);
+
+  switch (mode) {
+    case 0:
+      for (std::uint64_t i = 0; i < iterations; ++i) {
+        so_metrics::CounterAdd(records);
+      }
+      break;
+    case 1:
+      for (std::uint64_t i = 0; i < iterations; ++i) {
+        so_metrics::GaugeSet(level, static_cast<std::int64_t>(i));
+      }
+      break;
+    case 2:
+      for (std::uint64_t i = 0; i < iterations; ++i) {
+        so_metrics::HistogramObserve(sizes, i & 1023);
+      }
+      break;
+    default:
+      for (std::uint64_t i = 0; i < iterations; ++i) {
+        so_counter_add(1);
+      }
+      break;
+  }
+}
@@ -1,5 +1,9 @@
+#include "so_metrics_api.h"
 #include "so_singleton_api.h"
 
+#include <list>
+#include <mutex>
+
 namespace {
 
 class LocalSingletonTwo final {
@@ -9,10 +13,39 @@ class LocalSingletonTwo final {
     return instance;
   }
 
+  // 记录最近的 exported_value，超出上限时丢弃最旧的；返回当前保存的个数。
+  std::size_t Remember(int value) {
+    std::lock_guard<std::mutex> lock(mu_);
+    history_.push_back(value);
+    if (history_.size() > kMaxHistory) {
+      history_.pop_front();
+    }
+    return history_.size();
+  }
+
  private:
+  static constexpr std::size_t kMaxHistory = 16;
+
   LocalSingletonTwo() = default;
+
+  std::mutex mu_;
+  // 小对象（链表节点）从 owner 的进程级对象池分配，而不是各 so 自己走全局 new。
+  std::list<int, SoPoolAllocator<int>> history_;
 };
 
+// 句柄只在首次使用时注册一次；两个 consumer 注册同名 metric 拿到的是同一个句柄。
+struct ConsumerMetrics {
+  SoMetric* snapshots = so_metrics_register("consumer_snapshots_total", SO_METRIC_COUNTER);
+  SoMetric* last_value = so_metrics_register("consumer_last_exported_value", SO_METRIC_GAUGE);
+  SoMetric* two_values =
+      so_metrics_register("consumer_two_exported_value", SO_METRIC_HISTOGRAM);
+};
+
+ConsumerMetrics& Metrics() {
+  static ConsumerMetrics metrics;
+  return metrics;
+}
+
 }  // namespace
 
 extern "C" SINGLETON_DEMO_EXPORT ConsumerSnapshot consumer_two_snapshot() {
@@ -25,5 +58,13 @@ extern "C" SINGLETON_DEMO_EXPORT ConsumerSnapshot consumer_two_snapshot() {
   snapshot.exported_singleton_addr =
       reinterpret_cast<std::uintptr_t>(exported_instance);
   snapshot.exported_value = so_singleton_next();
+  snapshot.pooled_history_size =
+      LocalSingletonTwo::Instance().Remember(snapshot.exported_value);
+
+  ConsumerMetrics& metrics = Metrics();
+  so_metrics::CounterAdd(metrics.snapshots);
+  so_metrics::GaugeSet(metrics.last_value, snapshot.exported_value);
+  so_metrics::HistogramObserve(metrics.two_values,
+                               static_cast<std::uint64_t>(snapshot.exported_value));
   return snapshot;
 }
@@ -0,0 +1,122 @@
+#include "so_singleton_api.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+constexpr std::uint64_t kTotalOps = 16000000;
+
+using Clock = std::chrono::steady_clock;
+
+std::atomic<std::int64_t> g_single_atomic{0};
+
+// 与 StaticSingleton::Increment 相同的“单个共享原子变量”，noinline 让调用成本与跨 so 调用可比。
+__attribute__((noinline)) void SingleAtomicAdd() {
+  g_single_atomic.fetch_add(1, std::memory_order_relaxed);
+}
+
+struct Backend {
+  const char* name;
+  void (*add_one)();
+  // 返回当前计数，用于校验没有丢失更新。
+  std::int64_t (*read)();
+};
+
+const Backend kBackends[] = {
+    {"mutex (so_singleton_next)",
+     [] { so_singleton_next(); },
+     [] { return static_cast<std::int64_t>(*so_singleton_instance()); }},
+    {"single atomic",
+     [] { SingleAtomicAdd(); },
+     [] { return g_single_atomic.load(std::memory_order_relaxed); }},
+    {"sharded per-thread",
+     [] { so_counter_add(1); },
+     [] { return so_counter_read_exact(); }},
+    {"sharded per-cpu",
+     [] { so_counter_add_percpu(1); },
+     [] { return so_counter_read_exact(); }},
+};
+
+// 总操作数固定，平均分给各线程；返回吞吐（Mops/s），并通过 ok 报告计数是否精确。
+double Measure(const Backend& backend, int threads, bool& ok) {
+  const std::uint64_t per_thread = kTotalOps / static_cast<std::uint64_t>(threads);
+  const std::int64_t before = backend.read();
+
+  std::atomic<int> ready{0};
+  std::atomic<bool> go{false};
+  std::vector<std::thread> workers;
+  workers.reserve(threads);
+  for (int t = 0; t < threads; ++t) {
+    workers.emplace_back([&]() {
+      ready.fetch_add(1, std::memory_order_acq_rel);
+      while (!go.load(std::memory_order_acquire)) {
+        std::this_thread::yield();
+      }
+      for (std::uint64_t i = 0; i < per_thread; ++i) {
+        backend.add_one();
+      }
+    });
+  }
+  while (ready.load(std::memory_order_acquire) != threads) {
+    std::this_thread::yield();
+  }
+
+  const auto begin = Clock::now();
+  go.store(true, std::memory_order_release);
+  for (auto& worker : workers) {
+    worker.join();
+  }
+  const std::chrono::duration<double> elapsed = Clock::now() - begin;
+
+  const std::uint64_t total = per_thread * static_cast<std::uint64_t>(threads);
+  ok = backend.read() - before == static_cast<std::int64_t>(total);
+  return static_cast<double>(total) / elapsed.count() / 1e6;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  const int max_threads = argc >= 2 ? std::atoi(argv[1]) : 64;
+  if (max_threads <= 0) {
+    std::cerr << "usage: " << argv[0] << " [max_threads]\n";
+    return 2;
+  }
+
+  std::vector<int> thread_counts;
+  for (int t = 1; t < max_threads; t *= 2) {
+    thread_counts.push_back(t);
+  }
+  thread_counts.push_back(max_threads);
+
+  std::cout << "== counter scaling (Mops/s, " << kTotalOps << " increments per cell, "
+            << std::thread::hardware_concurrency() << " CPUs) ==\n";
+  std::cout << std::left << std::setw(28) << "BACKEND";
+  for (const int threads : thread_counts) {
+    std::cout << std::right << std::setw(9) << ("T=" + std::to_string(threads));
+  }
+  std::cout << '\n';
+
+  bool all_exact = true;
+  for (const auto& backend : kBackends) {
+    std::cout << std::left << std::setw(28) << backend.name << std::right << std::fixed
+              << std::setprecision(1);
+    for (const int threads : thread_counts) {
+      bool ok = false;
+      std::cout << std::setw(9) << Measure(backend, threads, ok);
+      all_exact = all_exact && ok;
+    }
+    std::cout << '\n';
+  }
+
+  std::cout << "exact counts: " << (all_exact ? "YES" : "NO") << '\n';
+  return all_exact ? 0 : 1;
+}
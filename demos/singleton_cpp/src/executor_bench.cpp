@@ -0,0 +1,169 @@
+#include "so_singleton_api.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+namespace {
+
+constexpr int kLatencySamples = 2000;
+constexpr int kForkJoinRounds = 2000;
+constexpr int kForkJoinTasks[] = {1, 4, 8, 16, 64};
+
+using Clock = std::chrono::steady_clock;
+
+std::int64_t NowNs() {
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+             Clock::now().time_since_epoch())
+      .count();
+}
+
+struct LatencyProbe {
+  std::int64_t submit_ns = 0;
+  std::atomic<std::int64_t> start_ns{0};
+};
+
+void RecordStart(void* arg) {
+  static_cast<LatencyProbe*>(arg)->start_ns.store(NowNs(), std::memory_order_release);
+}
+
+void WaitStarted(const LatencyProbe& probe) {
+  while (probe.start_ns.load(std::memory_order_acquire) == 0) {
+    std::this_thread::yield();
+  }
+}
+
+struct Percentiles {
+  double p50_us = 0;
+  double p99_us = 0;
+  double max_us = 0;
+};
+
+Percentiles Summarize(std::vector<std::int64_t>& samples) {
+  std::sort(samples.begin(), samples.end());
+  Percentiles result;
+  result.p50_us = samples[samples.size() / 2] / 1e3;
+  result.p99_us = samples[samples.size() * 99 / 100] / 1e3;
+  result.max_us = samples.back() / 1e3;
+  return result;
+}
+
+/*
+ * submit-to-start：从调用方提交到任务函数第一行开始执行的时间。
+ * idle_gap 为 true 时每次提交前先睡 2ms，让 worker 走完自旋真正 park，测的是唤醒路径。
+ */
+std::vector<std::int64_t> ExecutorLatency(bool idle_gap) {
+  std::vector<std::int64_t> samples;
+  samples.reserve(kLatencySamples);
+  for (int i = 0; i < kLatencySamples; ++i) {
+    if (idle_gap) {
+      std::this_thread::sleep_for(std::chrono::milliseconds(2));
+    }
+    LatencyProbe probe;
+    probe.submit_ns = NowNs();
+    so_executor_submit(&RecordStart, &probe);
+    WaitStarted(probe);
+    samples.push_back(probe.start_ns.load(std::memory_order_relaxed) - probe.submit_ns);
+  }
+  return samples;
+}
+
+std::vector<std::int64_t> SpawnLatency() {
+  std::vector<std::int64_t> samples;
+  samples.reserve(kLatencySamples);
+  for (int i = 0; i < kLatencySamples; ++i) {
+    LatencyProbe probe;
+    probe.submit_ns = NowNs();
+    std::thread thread(&RecordStart, &probe);
+    thread.join();
+    samples.push_back(probe.start_ns.load(std::memory_order_relaxed) - probe.submit_ns);
+  }
+  return samples;
+}
+
+// fork/join 只测调度本身：任务体只是一次 relaxed 累加。
+std::atomic<std::uint64_t> g_sink{0};
+
+void TinyTask(void*, int index) {
+  g_sink.fetch_add(static_cast<std::uint64_t>(index), std::memory_order_relaxed);
+}
+
+double ExecutorForkJoinUs(int tasks) {
+  const auto begin = Clock::now();
+  for (int round = 0; round < kForkJoinRounds; ++round) {
+    so_executor_parallel_for(tasks, &TinyTask, nullptr);
+  }
+  const std::chrono::duration<double, std::micro> elapsed = Clock::now() - begin;
+  return elapsed.count() / kForkJoinRounds;
+}
+
+// 与 so_executor_parallel_for 一样由调用方亲自执行下标 0，只为其余 tasks - 1 个下标起线程；
+// 否则 TASKS=1 时一边完全不调度、一边起一个线程，比较没有意义。
+double SpawnForkJoinUs(int tasks) {
+  std::vector<std::thread> threads;
+  threads.reserve(tasks);
+  const auto begin = Clock::now();
+  for (int round = 0; round < kForkJoinRounds; ++round) {
+    for (int i = 1; i < tasks; ++i) {
+      threads.emplace_back(&TinyTask, nullptr, i);
+    }
+    TinyTask(nullptr, 0);
+    for (auto& thread : threads) {
+      thread.join();
+    }
+    threads.clear();
+  }
+  const std::chrono::duration<double, std::micro> elapsed = Clock::now() - begin;
+  return elapsed.count() / kForkJoinRounds;
+}
+
+void PrintLatencyRow(const char* name, std::vector<std::int64_t> samples) {
+  const Percentiles p = Summarize(samples);
+  std::cout << std::left << std::setw(26) << name << std::right << std::fixed
+            << std::setprecision(1) << std::setw(10) << p.p50_us << std::setw(10) << p.p99_us
+            << std::setw(10) << p.max_us << '\n';
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  const int workers = argc >= 2 ? std::atoi(argv[1]) : 0;
+  const bool pin = argc >= 3 && std::strcmp(argv[2], "pin") == 0;
+  if (workers < 0 || (argc >= 3 && !pin)) {
+    std::cerr << "usage: " << argv[0] << " [workers] [pin]\n";
+    return 2;
+  }
+  so_executor_configure(workers, pin ? 1 : 0);
+
+  std::cout << "== so_executor vs raw std::thread ==\n"
+            << "workers: " << so_executor_worker_count() << (pin ? " (pinned)" : "")
+            << ", cpus: " << std::thread::hardware_concurrency() << "\n\n";
+
+  std::cout << "-- submit-to-start latency (" << kLatencySamples << " samples, us) --\n"
+            << std::left << std::setw(26) << "MODE" << std::right << std::setw(10) << "p50"
+            << std::setw(10) << "p99" << std::setw(10) << "max" << '\n';
+  PrintLatencyRow("executor (hot)", ExecutorLatency(false));
+  PrintLatencyRow("executor (parked)", ExecutorLatency(true));
+  PrintLatencyRow("std::thread spawn", SpawnLatency());
+
+  std::cout << "\n-- fork/join overhead (" << kForkJoinRounds << " rounds, us per round) --\n"
+            << "both sides run task 0 on the caller; TASKS=1 therefore dispatches nothing\n"
+            << std::left << std::setw(8) << "TASKS" << std::right << std::setw(14)
+            << "executor" << std::setw(14) << "spawn+join" << std::setw(10) << "speedup"
+            << '\n';
+  for (const int tasks : kForkJoinTasks) {
+    const double pooled = ExecutorForkJoinUs(tasks);
+    const double spawned = SpawnForkJoinUs(tasks);
+    std::cout << std::left << std::setw(8) << tasks << std::right << std::fixed
+              << std::setprecision(2) << std::setw(14) << pooled << std::setw(14) << spawned
+              << std::setw(9) << std::setprecision(1) << spawned / pooled << "x\n";
+  }
+  return 0;
+}
@@ -0,0 +1,82 @@
+#include "singleton_strategies.h"
+#include "so_singleton_api.h"
+
+#include <cstdint>
+
+#include "bench_harness.h"
+
+namespace {
+
+template <typename Singleton>
+void AddAccess(bench::Suite& suite, const char* name) {
+  suite.Add(name, [](bench::State& state) {
+    for (std::uint64_t i = 0; i < state.iterations(); ++i) {
+      bench::DoNotOptimize(&Singleton::Instance().payload);
+    }
+  });
+}
+
+void NoopTask(void*, int) {}
+
+}  // namespace
+
+/*
+ * singleton_cpp 各热路径的统一格式 benchmark（单线程）：
+ * - 5 种单例写法初始化之后的单次访问；
+ * - owner 导出的分片计数器、对象池、metrics 记录、线程池 fork/join。
+ * 多线程扩展性仍看各自的 *_bench。
+ */
+int main(int argc, char** argv) {
+  bench::Suite suite("singleton_cpp");
+  AddAccess<singleton_strategies::StaticLocalSingleton>(suite, "access/static_local");
+  AddAccess<singleton_strategies::CallOnceSingleton>(suite, "access/call_once");
+  AddAccess<singleton_strategies::DoubleCheckedSingleton>(suite, "access/double_checked");
+  AddAccess<singleton_strategies::ThreadLocalCachedSingleton>(suite, "access/thread_local_cached");
+  AddAccess<singleton_strategies::ConstantInitSingleton>(suite, "access/constant_init");
+
+  suite.Add("so_singleton_next", [](bench::State& state) {
+    for (std::uint64_t i = 0; i < state.iterations(); ++i) {
+      bench::DoNotOptimize(so_singleton_next());
+    }
+  });
+  suite.Add("so_counter_add", [](bench::State& state) {
+    for (std::uint64_t i = 0; i < state.iterations(); ++i) {
+      so_counter_add(1);
+    }
+  });
+  suite.Add("so_counter_add_percpu", [](bench::State& state) {
+    for (std::uint64_t i = 0; i < state.iterations(); ++i) {
+      so_counter_add_percpu(1);
+    }
+  });
+
+  // 分配后立即释放：命中线程缓存的快路径。
+  suite.Add("so_pool_alloc+free/64B", [](bench::State& state) {
+    for (std::uint64_t i = 0; i < state.iterations(); ++i) {
+      void* ptr = so_pool_alloc(64);
+      bench::DoNotOptimize(ptr);
+      so_pool_free(ptr, 64);
+    }
+  });
+
+  // 记录循环在 consumer_one 内部执行，与 metrics_bench 相同；mode 含义见 so_singleton_api.h。
+  suite.Add("metrics/counter", [](bench::State& state) {
+    consumer_one_record_metrics(0, state.iterations());
+  });
+  suite.Add("metrics/gauge", [](bench::State& state) {
+    consumer_one_record_metrics(1, state.iterations());
+  });
+  suite.Add("metrics/histogram", [](bench::State& state) {
+    consumer_one_record_metrics(2, state.iterations());
+  });
+  suite.Add("metrics/cross_so_counter_add", [](bench::State& state) {
+    consumer_one_record_metrics(3, state.iterations());
+  });
+
+  // 空任务的 fork/join 往返：只剩调度、唤醒与汇合的成本。
+  suite.AddLatency("so_executor_parallel_for/4_noop", [] {
+    so_executor_parallel_for(4, &NoopTask, nullptr);
+  });
+
+  return suite.Run(argc, argv);
+}
@@ -1,3 +1,4 @@
+#include "so_metrics_api.h"
 #include "so_singleton_api.h"
 
 #include <atomic>
@@ -6,8 +7,7 @@
 #include <iostream>
 #include <mutex>
 #include <sstream>
-#include <thread>
-#include <vector>
+#include <string>
 
 namespace {
 
@@ -74,20 +74,18 @@ class HeapSingleton final {
 std::once_flag HeapSingleton::init_flag_;
 HeapSingleton* HeapSingleton::instance_ = nullptr;
 
+// kThreadCount 个并发任务交给 owner 里的共享线程池执行，不再每次临时创建/回收线程。
 template <typename Func>
 void RunInThreads(Func func) {
-  std::vector<std::thread> threads;
-  threads.reserve(kThreadCount);
-  for (int i = 0; i < kThreadCount; ++i) {
-    threads.emplace_back([&func]() {
-      for (int j = 0; j < kLoopPerThread; ++j) {
-        func();
-      }
-    });
-  }
-  for (auto& thread : threads) {
-    thread.join();
-  }
+  so_executor_parallel_for(
+      kThreadCount,
+      [](void* arg, int) {
+        Func& task = *static_cast<Func*>(arg);
+        for (int j = 0; j < kLoopPerThread; ++j) {
+          task();
+        }
+      },
+      &func);
 }
 
 void PrintSnapshot(const ConsumerSnapshot& snapshot) {
@@ -96,7 +94,8 @@ void PrintSnapshot(const ConsumerSnapshot& snapshot) {
             << HexAddr(snapshot.local_singleton_addr) << '\n'
             << "  exported singleton addr : "
             << HexAddr(snapshot.exported_singleton_addr) << '\n'
-            << "  exported value          : " << snapshot.exported_value << '\n';
+            << "  exported value          : " << snapshot.exported_value << '\n'
+            << "  pooled history size     : " << snapshot.pooled_history_size << '\n';
 }
 
 void DemoInProcessSingletons() {
@@ -142,6 +141,40 @@ void DemoSoSafeSingleton() {
             << (exported_shared ? "YES" : "NO") << '\n';
 }
 
+void DemoShardedCounter() {
+  const std::int64_t before = so_counter_read_exact();
+  RunInThreads([]() {
+    so_counter_add(1);
+  });
+
+  const int expected = kThreadCount * kLoopPerThread;
+  std::cout << "[sharded counter (owner so)]\n"
+            << "  value : " << so_counter_read_exact() - before
+            << " (expected " << expected << ")\n";
+}
+
+void DemoMetricsRegistry() {
+  // 两个 consumer 在 DemoSoSafeSingleton 里已各记录过一次，这里再各调用一轮。
+  consumer_one_snapshot();
+  consumer_two_snapshot();
+
+  const std::size_t size = so_metrics_export(nullptr, 0);
+  std::string text(size + 1, '\0');
+  so_metrics_export(&text[0], text.size());
+  text.resize(size);
+
+  // 直方图有 40 个累积桶，这里只保留 +Inf 桶，完整内容见 so_metrics_export。
+  std::istringstream lines(text);
+  std::string line;
+  while (std::getline(lines, line)) {
+    if (line.find("_bucket{") != std::string::npos &&
+        line.find("+Inf") == std::string::npos) {
+      continue;
+    }
+    std::cout << "  " << line << '\n';
+  }
+}
+
 }  // namespace
 
 int main() {
@@ -150,5 +183,11 @@ int main() {
 
   std::cout << "\n== 2) If exporting .so, keep one singleton owner ==\n";
   DemoSoSafeSingleton();
+
+  std::cout << "\n== 3) Contention-free counter behind the same C ABI ==\n";
+  DemoShardedCounter();
+
+  std::cout << "\n== 4) Process-wide metrics registry owned by singleton_owner ==\n";
+  DemoMetricsRegistry();
   return 0;
 }
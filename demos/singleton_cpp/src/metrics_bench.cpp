@@ -0,0 +1,117 @@
+#include "so_metrics_api.h"
+#include "so_singleton_api.h"
+
+#include <atomic>
+#include <cstdint>
+#include <cstdlib>
+#include <ctime>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+constexpr std::uint64_t kRecordsPerThread = 20000000;
+
+struct Mode {
+  int id;
+  const char* name;
+};
+
+const Mode kModes[] = {
+    {0, "counter add (tls buffer)"},
+    {1, "gauge set (shared atomic)"},
+    {2, "histogram observe (tls buffer)"},
+    {3, "so_counter_add (cross-.so call)"},
+};
+
+std::uint64_t ThreadCpuNs() {
+  timespec ts{};
+  ::clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+  return static_cast<std::uint64_t>(ts.tv_sec) * 1000000000ULL +
+         static_cast<std::uint64_t>(ts.tv_nsec);
+}
+
+// 记录循环在 consumer_one.so 内部执行，这里只跨 so 调用一次；返回平均每条记录的 ns。
+double MeasureRecordNs(int mode, int threads) {
+  std::vector<std::uint64_t> elapsed(threads, 0);
+  std::vector<std::thread> workers;
+  workers.reserve(threads);
+  for (int t = 0; t < threads; ++t) {
+    workers.emplace_back([&, t]() {
+      // 预热：完成句柄注册和线程缓冲区绑定。
+      consumer_one_record_metrics(mode, 1000);
+      const std::uint64_t begin = ThreadCpuNs();
+      consumer_one_record_metrics(mode, kRecordsPerThread);
+      elapsed[t] = ThreadCpuNs() - begin;
+    });
+  }
+  for (auto& worker : workers) {
+    worker.join();
+  }
+
+  std::uint64_t total = 0;
+  for (const auto ns : elapsed) {
+    total += ns;
+  }
+  return static_cast<double>(total) / (static_cast<double>(kRecordsPerThread) * threads);
+}
+
+std::string FindLine(const std::string& text, const std::string& prefix) {
+  std::istringstream lines(text);
+  std::string line;
+  while (std::getline(lines, line)) {
+    if (line.compare(0, prefix.size(), prefix) == 0) {
+      return line;
+    }
+  }
+  return prefix + " <missing>";
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  const int max_threads = argc >= 2 ? std::atoi(argv[1]) : 8;
+  if (max_threads <= 0) {
+    std::cerr << "usage: " << argv[0] << " [max_threads]\n";
+    return 2;
+  }
+
+  std::vector<int> thread_counts;
+  for (int t = 1; t < max_threads; t *= 2) {
+    thread_counts.push_back(t);
+  }
+  thread_counts.push_back(max_threads);
+
+  std::cout << "== metrics record cost inside consumer_one.so (ns/record) ==\n";
+  std::cout << std::left << std::setw(34) << "MODE";
+  for (const int threads : thread_counts) {
+    std::cout << std::right << std::setw(9) << ("T=" + std::to_string(threads));
+  }
+  std::cout << '\n';
+
+  for (const auto& mode : kModes) {
+    std::cout << std::left << std::setw(34) << mode.name << std::right << std::fixed
+              << std::setprecision(2);
+    for (const int threads : thread_counts) {
+      std::cout << std::setw(9) << MeasureRecordNs(mode.id, threads);
+    }
+    std::cout << '\n';
+  }
+
+  // 校验汇总结果：counter 总数应等于所有线程记录次数之和（含预热）。
+  std::uint64_t expected = 0;
+  for (const int threads : thread_counts) {
+    expected += (kRecordsPerThread + 1000) * static_cast<std::uint64_t>(threads);
+  }
+  std::string text(so_metrics_export(nullptr, 0) + 1, '\0');
+  text.resize(so_metrics_export(&text[0], text.size()));
+
+  const std::string counter_line = FindLine(text, "consumer_one_bench_records_total ");
+  std::cout << "\nmerged: " << counter_line << " (expected " << expected << ")\n"
+            << "merged: " << FindLine(text, "consumer_one_bench_size_count ") << '\n';
+  return counter_line == "consumer_one_bench_records_total " + std::to_string(expected) ? 0 : 1;
+}
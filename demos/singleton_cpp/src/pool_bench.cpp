@@ -0,0 +1,197 @@
+#include "so_singleton_api.h"
+
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+constexpr int kLiveObjects = 8192;
+constexpr std::uint64_t kMixedOpsPerThread = 4000000;
+constexpr int kBulkBatch = 256;
+constexpr int kBulkRoundsPerThread = 8000;
+
+using Clock = std::chrono::steady_clock;
+
+struct AllocatorOps {
+  const char* name;
+  void* (*alloc)(std::size_t size);
+  void (*free)(void* ptr, std::size_t size);
+  void (*free_bulk)(void* const* ptrs, std::size_t count, std::size_t size);
+};
+
+const AllocatorOps kAllocators[] = {
+    {"glibc malloc",
+     [](std::size_t size) { return std::malloc(size); },
+     [](void* ptr, std::size_t) { std::free(ptr); },
+     [](void* const* ptrs, std::size_t count, std::size_t) {
+       for (std::size_t i = 0; i < count; ++i) {
+         std::free(ptrs[i]);
+       }
+     }},
+    {"so_pool", &so_pool_alloc, &so_pool_free, &so_pool_free_bulk},
+};
+
+struct CellResult {
+  double mixed_mops = 0;
+  double bulk_mops = 0;
+  long max_rss_kb = 0;
+};
+
+std::uint64_t NextRandom(std::uint64_t& state) {
+  state ^= state << 13;
+  state ^= state >> 7;
+  state ^= state << 17;
+  return state;
+}
+
+// 16..512 字节的随机尺寸，覆盖插件里常见的小对象。
+std::size_t RandomSize(std::uint64_t& state) {
+  return 16 + NextRandom(state) % 497;
+}
+
+/*
+ * 混合负载：每个线程维持 kLiveObjects 个存活对象，随机挑一个释放后再分配一个新尺寸，
+ * 模拟长期运行的插件里“边分配边释放”的碎片化场景。
+ */
+void MixedWorkload(const AllocatorOps& ops, std::uint64_t seed) {
+  std::vector<void*> live(kLiveObjects);
+  std::vector<std::size_t> sizes(kLiveObjects);
+  std::uint64_t state = seed;
+  for (int i = 0; i < kLiveObjects; ++i) {
+    sizes[i] = RandomSize(state);
+    live[i] = ops.alloc(sizes[i]);
+    std::memset(live[i], 0, 1);
+  }
+  for (std::uint64_t op = 0; op < kMixedOpsPerThread; ++op) {
+    const std::size_t slot = NextRandom(state) % kLiveObjects;
+    ops.free(live[slot], sizes[slot]);
+    sizes[slot] = RandomSize(state);
+    live[slot] = ops.alloc(sizes[slot]);
+    static_cast<char*>(live[slot])[0] = static_cast<char>(op);
+  }
+  for (int i = 0; i < kLiveObjects; ++i) {
+    ops.free(live[i], sizes[i]);
+  }
+}
+
+// 批量负载：一次分配 kBulkBatch 个同尺寸对象，再一次性批量释放。
+void BulkWorkload(const AllocatorOps& ops, std::uint64_t seed) {
+  void* batch[kBulkBatch];
+  std::uint64_t state = seed;
+  for (int round = 0; round < kBulkRoundsPerThread; ++round) {
+    const std::size_t size = RandomSize(state);
+    for (int i = 0; i < kBulkBatch; ++i) {
+      batch[i] = ops.alloc(size);
+      static_cast<char*>(batch[i])[0] = static_cast<char>(i);
+    }
+    ops.free_bulk(batch, kBulkBatch, size);
+  }
+}
+
+template <typename Workload>
+double RunThreads(int threads, Workload workload) {
+  std::vector<std::thread> workers;
+  workers.reserve(threads);
+  const auto begin = Clock::now();
+  for (int t = 0; t < threads; ++t) {
+    workers.emplace_back([&workload, t]() {
+      workload(0x9E3779B97F4A7C15ULL * static_cast<std::uint64_t>(t + 1));
+    });
+  }
+  for (auto& worker : workers) {
+    worker.join();
+  }
+  const std::chrono::duration<double> elapsed = Clock::now() - begin;
+  return elapsed.count();
+}
+
+CellResult RunCell(const AllocatorOps& ops, int threads) {
+  CellResult result;
+  const double mixed_seconds =
+      RunThreads(threads, [&ops](std::uint64_t seed) { MixedWorkload(ops, seed); });
+  const double bulk_seconds =
+      RunThreads(threads, [&ops](std::uint64_t seed) { BulkWorkload(ops, seed); });
+
+  // 每次操作 = 一次分配 + 一次释放。
+  result.mixed_mops =
+      static_cast<double>(kMixedOpsPerThread) * threads / mixed_seconds / 1e6;
+  result.bulk_mops =
+      static_cast<double>(kBulkBatch) * kBulkRoundsPerThread * threads / bulk_seconds / 1e6;
+
+  rusage usage{};
+  ::getrusage(RUSAGE_SELF, &usage);
+  result.max_rss_kb = usage.ru_maxrss;
+  return result;
+}
+
+// 每个单元格在独立子进程里跑，峰值 RSS 互不污染。
+bool RunCellInChild(const AllocatorOps& ops, int threads, CellResult& result) {
+  int fds[2];
+  if (::pipe(fds) != 0) {
+    return false;
+  }
+  std::cout.flush();
+  const pid_t pid = ::fork();
+  if (pid == 0) {
+    ::close(fds[0]);
+    const CellResult child = RunCell(ops, threads);
+    const ssize_t written = ::write(fds[1], &child, sizeof(child));
+    ::_exit(written == static_cast<ssize_t>(sizeof(child)) ? 0 : 1);
+  }
+  ::close(fds[1]);
+  const bool ok =
+      pid > 0 && ::read(fds[0], &result, sizeof(result)) == static_cast<ssize_t>(sizeof(result));
+  ::close(fds[0]);
+  if (pid > 0) {
+    ::waitpid(pid, nullptr, 0);
+  }
+  return ok;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  const int max_threads = argc >= 2 ? std::atoi(argv[1]) : 8;
+  if (max_threads <= 0) {
+    std::cerr << "usage: " << argv[0] << " [max_threads]\n";
+    return 2;
+  }
+
+  std::vector<int> thread_counts;
+  for (int t = 1; t < max_threads; t *= 2) {
+    thread_counts.push_back(t);
+  }
+  thread_counts.push_back(max_threads);
+
+  std::cout << "== small-object allocator: glibc malloc vs so_pool ==\n"
+            << "mixed: " << kLiveObjects << " live objects/thread, random free+alloc, 16..512B\n"
+            << "bulk : " << kBulkBatch << " same-size allocs then one bulk free\n\n";
+  std::cout << std::left << std::setw(14) << "ALLOCATOR" << std::setw(9) << "THREADS"
+            << std::setw(16) << "MIXED Mops/s" << std::setw(15) << "BULK Mops/s"
+            << "MAX RSS (KB)\n";
+
+  for (const int threads : thread_counts) {
+    for (const auto& ops : kAllocators) {
+      CellResult result;
+      if (!RunCellInChild(ops, threads, result)) {
+        std::cerr << "benchmark child failed\n";
+        return 1;
+      }
+      std::cout << std::left << std::setw(14) << ops.name << std::setw(9) << threads
+                << std::fixed << std::setprecision(1) << std::setw(16) << result.mixed_mops
+                << std::setw(15) << result.bulk_mops << result.max_rss_kb << '\n';
+    }
+  }
+  return 0;
+}
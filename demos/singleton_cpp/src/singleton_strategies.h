@@ -0,0 +1,126 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+
+/*
+ * 同一个“计数器单例”的 5 种初始化/访问写法，供 access_bench 对比每次访问的成本。
+ * 每种写法的 Instance() 都保持与 main.cpp 里对应写法一致的语义：首次访问时构造，之后返回同一对象。
+ */
+namespace singleton_strategies {
+
+struct Payload {
+  std::uint64_t value = 0;
+};
+
+// 1) 函数内 static：每次访问都要检查一次 guard 变量（已初始化后是一次 acquire load + 分支）。
+class StaticLocalSingleton final {
+ public:
+  static StaticLocalSingleton& Instance() {
+    static StaticLocalSingleton instance;
+    return instance;
+  }
+
+  Payload payload;
+
+ private:
+  StaticLocalSingleton() = default;
+};
+
+// 2) 堆区 + std::call_once：每次访问都进入 call_once 的快路径检查。
+class CallOnceSingleton final {
+ public:
+  static CallOnceSingleton& Instance() {
+    std::call_once(init_flag_, [] {
+      instance_ = new CallOnceSingleton();
+    });
+    return *instance_;
+  }
+
+  Payload payload;
+
+ private:
+  CallOnceSingleton() = default;
+
+  static std::once_flag init_flag_;
+  static CallOnceSingleton* instance_;
+};
+
+inline std::once_flag CallOnceSingleton::init_flag_;
+inline CallOnceSingleton* CallOnceSingleton::instance_ = nullptr;
+
+// 3) 双重检查 + 原子指针：快路径只有一次 acquire load 和判空。
+class DoubleCheckedSingleton final {
+ public:
+  static DoubleCheckedSingleton& Instance() {
+    DoubleCheckedSingleton* instance = instance_.load(std::memory_order_acquire);
+    if (instance != nullptr) {
+      return *instance;
+    }
+
+    std::lock_guard<std::mutex> lock(mu_);
+    instance = instance_.load(std::memory_order_relaxed);
+    if (instance == nullptr) {
+      instance = new DoubleCheckedSingleton();
+      instance_.store(instance, std::memory_order_release);
+    }
+    return *instance;
+  }
+
+  Payload payload;
+
+ private:
+  DoubleCheckedSingleton() = default;
+
+  static std::mutex mu_;
+  static std::atomic<DoubleCheckedSingleton*> instance_;
+};
+
+inline std::mutex DoubleCheckedSingleton::mu_;
+inline std::atomic<DoubleCheckedSingleton*> DoubleCheckedSingleton::instance_{nullptr};
+
+// 4) thread_local 缓存引用：每个线程首次访问走一次 static local，之后只读 TLS 里的指针。
+class ThreadLocalCachedSingleton final {
+ public:
+  static ThreadLocalCachedSingleton& Instance() {
+    thread_local ThreadLocalCachedSingleton* cached = &Create();
+    return *cached;
+  }
+
+  Payload payload;
+
+ private:
+  ThreadLocalCachedSingleton() = default;
+
+  static ThreadLocalCachedSingleton& Create() {
+    static ThreadLocalCachedSingleton instance;
+    return instance;
+  }
+};
+
+/*
+ * 5) 常量初始化：构造函数是 constexpr，对象在编译期就放进 .data/.bss，
+ *    不存在“首次访问”的概念，访问就是取一个地址。C++20 下用 constinit 让编译器强制检查。
+ */
+class ConstantInitSingleton final {
+ public:
+  static ConstantInitSingleton& Instance() {
+    return instance_;
+  }
+
+  Payload payload;
+
+ private:
+  constexpr ConstantInitSingleton() = default;
+
+  static ConstantInitSingleton instance_;
+};
+
+#if defined(__cpp_constinit) && __cpp_constinit >= 201907L
+inline constinit ConstantInitSingleton ConstantInitSingleton::instance_;
+#else
+inline ConstantInitSingleton ConstantInitSingleton::instance_;
+#endif
+
+}  // namespace singleton_strategies
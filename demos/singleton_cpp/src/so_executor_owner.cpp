@@ -0,0 +1,278 @@
+#include "so_singleton_api.h"
+
+#include <pthread.h>
+#include <sched.h>
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace {
+
+// 找不到任务时先自旋这么多轮再 park，兼顾唤醒延迟与空转 CPU。
+constexpr int kSpinRoundsBeforePark = 256;
+
+struct Task {
+  SoTaskFn simple = nullptr;
+  SoIndexedTaskFn indexed = nullptr;
+  void* arg = nullptr;
+  int index = 0;
+  // fork/join 任务完成时递减，由等待方轮询归零。
+  std::atomic<int>* pending = nullptr;
+
+  void Run() const {
+    if (simple != nullptr) {
+      simple(arg);
+    } else {
+      indexed(arg, index);
+    }
+    if (pending != nullptr) {
+      pending->fetch_sub(1, std::memory_order_acq_rel);
+    }
+  }
+};
+
+/*
+ * 每个 worker 一个双端队列：自己从尾部 LIFO 取（缓存更热），其他线程从头部 FIFO 偷。
+ * 队列用一把小锁保护；锁只在同一队列的 owner 与 thief 之间竞争，远比全局队列轻。
+ */
+class alignas(64) WorkDeque {
+ public:
+  void PushBack(const Task& task) {
+    std::lock_guard<std::mutex> lock(mu_);
+    tasks_.push_back(task);
+  }
+
+  bool PopBack(Task& task) {
+    std::lock_guard<std::mutex> lock(mu_);
+    if (tasks_.empty()) {
+      return false;
+    }
+    task = tasks_.back();
+    tasks_.pop_back();
+    return true;
+  }
+
+  bool StealFront(Task& task) {
+    std::lock_guard<std::mutex> lock(mu_);
+    if (tasks_.empty()) {
+      return false;
+    }
+    task = tasks_.front();
+    tasks_.pop_front();
+    return true;
+  }
+
+ private:
+  std::mutex mu_;
+  std::deque<Task> tasks_;
+};
+
+/*
+ * 进程级 work-stealing executor，只存在于 owner so，所有业务 so 共用一组 worker。
+ * - 外部线程提交：轮转放进各 worker 队列；worker 线程内提交：放进自己的队列。
+ * - 空闲 worker 先偷其他队列，再自旋，最后在条件变量上 park。
+ * - pending_ 与 sleepers_ 都是 seq_cst：提交方先增 pending_ 再看 sleepers_，
+ *   park 方在锁内先增 sleepers_ 再看 pending_，两边至少有一方能看到对方，不会丢唤醒。
+ */
+class Executor final {
+ public:
+  static Executor& Instance() {
+    // 故意不释放：worker 线程在进程退出前一直 park 在这里。
+    static Executor* instance = new Executor();
+    return *instance;
+  }
+
+  bool Configure(int workers, bool pin) {
+    std::lock_guard<std::mutex> lock(start_mu_);
+    if (started_) {
+      return false;
+    }
+    requested_workers_ = workers;
+    pin_ = pin;
+    return true;
+  }
+
+  void Submit(const Task& task) {
+    EnsureStarted();
+    const int self = current_worker_;
+    const int target =
+        self >= 0 ? self
+                  : static_cast<int>(next_queue_.fetch_add(1, std::memory_order_relaxed) %
+                                     queues_.size());
+    queues_[target]->PushBack(task);
+    pending_.fetch_add(1);
+    if (sleepers_.load() > 0) {
+      std::lock_guard<std::mutex> lock(park_mu_);
+      park_cv_.notify_one();
+    }
+  }
+
+  void ParallelFor(int tasks, SoIndexedTaskFn fn, void* arg) {
+    if (tasks <= 0) {
+      return;
+    }
+    std::atomic<int> remaining{tasks};
+    // 第 0 个任务留给调用方自己跑，其余交给 worker。
+    for (int i = 1; i < tasks; ++i) {
+      Task task;
+      task.indexed = fn;
+      task.arg = arg;
+      task.index = i;
+      task.pending = &remaining;
+      Submit(task);
+    }
+    fn(arg, 0);
+    remaining.fetch_sub(1, std::memory_order_acq_rel);
+
+    // 等待期间调用方也去偷任务执行：既加速完成，也避免在 worker 线程里嵌套调用时死锁。
+    Task task;
+    while (remaining.load(std::memory_order_acquire) > 0) {
+      if (TryTake(task)) {
+        task.Run();
+      } else {
+        std::this_thread::yield();
+      }
+    }
+  }
+
+  int WorkerCount() {
+    EnsureStarted();
+    return static_cast<int>(queues_.size());
+  }
+
+ private:
+  Executor() = default;
+  Executor(const Executor&) = delete;
+  Executor& operator=(const Executor&) = delete;
+
+  void EnsureStarted() {
+    if (started_flag_.load(std::memory_order_acquire)) {
+      return;
+    }
+    std::lock_guard<std::mutex> lock(start_mu_);
+    if (started_) {
+      return;
+    }
+
+    int workers = requested_workers_;
+    if (workers <= 0) {
+      workers = static_cast<int>(std::thread::hardware_concurrency());
+    }
+    if (workers <= 0) {
+      workers = 1;
+    }
+    for (int i = 0; i < workers; ++i) {
+      queues_.push_back(std::make_unique<WorkDeque>());
+    }
+    for (int i = 0; i < workers; ++i) {
+      std::thread worker([this, i]() { WorkerLoop(i); });
+      if (pin_) {
+        PinToCore(worker.native_handle(), i);
+      }
+      worker.detach();
+    }
+    started_ = true;
+    started_flag_.store(true, std::memory_order_release);
+  }
+
+  static void PinToCore(pthread_t thread, int index) {
+    const unsigned cpus = std::thread::hardware_concurrency();
+    if (cpus == 0) {
+      return;
+    }
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(static_cast<int>(static_cast<unsigned>(index) % cpus), &set);
+    ::pthread_setaffinity_np(thread, sizeof(set), &set);
+  }
+
+  bool TryTake(Task& task) {
+    const int self = current_worker_;
+    if (self >= 0 && queues_[self]->PopBack(task)) {
+      pending_.fetch_sub(1);
+      return true;
+    }
+    const int count = static_cast<int>(queues_.size());
+    const int start = self >= 0 ? self + 1 : 0;
+    for (int i = 0; i < count; ++i) {
+      const int victim = (start + i) % count;
+      if (victim != self && queues_[victim]->StealFront(task)) {
+        pending_.fetch_sub(1);
+        return true;
+      }
+    }
+    return false;
+  }
+
+  void WorkerLoop(int index) {
+    current_worker_ = index;
+    Task task;
+    while (true) {
+      if (TryTake(task)) {
+        task.Run();
+        continue;
+      }
+
+      bool found = false;
+      for (int spin = 0; spin < kSpinRoundsBeforePark && !found; ++spin) {
+        if (pending_.load(std::memory_order_relaxed) > 0) {
+          found = true;
+        } else {
+          std::this_thread::yield();
+        }
+      }
+      if (found) {
+        continue;
+      }
+
+      std::unique_lock<std::mutex> lock(park_mu_);
+      sleepers_.fetch_add(1);
+      park_cv_.wait(lock, [this]() { return pending_.load() > 0; });
+      sleepers_.fetch_sub(1);
+    }
+  }
+
+  static thread_local int current_worker_;
+
+  std::mutex start_mu_;
+  bool started_ = false;
+  std::atomic<bool> started_flag_{false};
+  int requested_workers_ = 0;
+  bool pin_ = false;
+
+  std::vector<std::unique_ptr<WorkDeque>> queues_;
+  std::atomic<unsigned> next_queue_{0};
+  std::atomic<int> pending_{0};
+  std::atomic<int> sleepers_{0};
+  std::mutex park_mu_;
+  std::condition_variable park_cv_;
+};
+
+thread_local int Executor::current_worker_ = -1;
+
+}  // namespace
+
+extern "C" SINGLETON_DEMO_EXPORT int so_executor_configure(int workers, int pin_cores) {
+  return Executor::Instance().Configure(workers, pin_cores != 0) ? 0 : -1;
+}
+
+extern "C" SINGLETON_DEMO_EXPORT int so_executor_worker_count() {
+  return Executor::Instance().WorkerCount();
+}
+
+extern "C" SINGLETON_DEMO_EXPORT void so_executor_submit(SoTaskFn fn, void* arg) {
+  Task task;
+  task.simple = fn;
+  task.arg = arg;
+  Executor::Instance().Submit(task);
+}
+
+extern "C" SINGLETON_DEMO_EXPORT void so_executor_parallel_for(int tasks, SoIndexedTaskFn fn,
+                                                               void* arg) {
+  Executor::Instance().ParallelFor(tasks, fn, arg);
+}
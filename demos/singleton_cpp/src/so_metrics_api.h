@@ -0,0 +1,106 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+#include "singleton_export.h"
+
+/*
+ * 进程级 metrics registry，由 singleton_owner 独占持有。
+ *
+ * 使用方式（任意业务 so）：
+ *   1) 启动时注册一次：SoMetric* m = so_metrics_register("name", SO_METRIC_COUNTER);
+ *      同名同类型重复注册返回同一个句柄，句柄在进程生命周期内保持有效。
+ *   2) 热路径用下面的 inline 函数记录：写的是“当前线程在 owner 里的缓冲区”，
+ *      每个线程只在第一次记录时跨 so 调用一次 so_metrics_thread_buffer()，之后不跨 so、不加锁。
+ *   3) 需要导出时调用 so_metrics_export()，由 owner 汇总所有线程缓冲区。
+ */
+
+enum SoMetricKind : std::uint32_t {
+  SO_METRIC_COUNTER = 0,
+  SO_METRIC_GAUGE = 1,
+  SO_METRIC_HISTOGRAM = 2,
+};
+
+constexpr std::uint32_t kSoMetricsMaxCounters = 256;
+constexpr std::uint32_t kSoMetricsMaxHistograms = 32;
+// 第 i 个桶统计 [2^(i-1), 2^i) 的观测值（第 0 个桶是 0），最后一个桶兜底。
+constexpr std::uint32_t kSoMetricsHistogramBuckets = 40;
+constexpr std::size_t kSoMetricsCacheLine = 64;
+
+// 由 owner 分配、永不释放；业务 so 只读 kind/index，gauge 直接写 gauge_value。
+struct SoMetric {
+  const char* name;
+  SoMetricKind kind;
+  // counter / histogram 在线程缓冲区里的槽位下标。
+  std::uint32_t index;
+  // gauge 是“最后一次写入生效”的语义，不适合分线程，直接存一个共享原子值。
+  std::atomic<std::int64_t> gauge_value;
+};
+
+struct SoMetricsHistogramCells {
+  std::atomic<std::uint64_t> buckets[kSoMetricsHistogramBuckets];
+  std::atomic<std::uint64_t> count;
+  std::atomic<std::uint64_t> sum;
+};
+
+// 每个线程一份，只有所属线程写入（relaxed load + store），owner 汇总时 relaxed 读取。
+struct alignas(kSoMetricsCacheLine) SoMetricsThreadBuffer {
+  std::atomic<std::uint64_t> counters[kSoMetricsMaxCounters];
+  SoMetricsHistogramCells histograms[kSoMetricsMaxHistograms];
+};
+
+extern "C" {
+
+// 注册失败（名字为空、类型冲突或超出容量）返回 nullptr。
+SINGLETON_DEMO_EXPORT SoMetric* so_metrics_register(const char* name, SoMetricKind kind);
+// 返回调用线程专属的缓冲区（首次调用时分配，线程退出后保留，数据不丢）。
+SINGLETON_DEMO_EXPORT SoMetricsThreadBuffer* so_metrics_thread_buffer();
+// 以 Prometheus 文本格式导出到 buf，返回完整输出所需字节数（不含结尾 '\0'），语义同 snprintf。
+SINGLETON_DEMO_EXPORT std::size_t so_metrics_export(char* buf, std::size_t capacity);
+
+}  // extern "C"
+
+namespace so_metrics {
+
+inline SoMetricsThreadBuffer* ThreadBuffer() {
+  // 每个 so 各自缓存一份指针（inline 隐藏可见性），指向的是 owner 里同一块缓冲区。
+  // initial-exec：PIC 的业务 so 默认用 general-dynamic 模型，每次记录都要 call __tls_get_addr；
+  // 这里只有一个指针，即使业务 so 是 dlopen 进来的也放得进 glibc 预留的静态 TLS 余量。
+  static thread_local SoMetricsThreadBuffer* buffer __attribute__((tls_model("initial-exec"))) =
+      nullptr;
+  if (buffer == nullptr) {
+    buffer = so_metrics_thread_buffer();
+  }
+  return buffer;
+}
+
+inline void BumpCell(std::atomic<std::uint64_t>& cell, std::uint64_t delta) {
+  cell.store(cell.load(std::memory_order_relaxed) + delta, std::memory_order_relaxed);
+}
+
+inline void CounterAdd(const SoMetric* metric, std::uint64_t delta = 1) {
+  BumpCell(ThreadBuffer()->counters[metric->index], delta);
+}
+
+inline void GaugeSet(SoMetric* metric, std::int64_t value) {
+  metric->gauge_value.store(value, std::memory_order_relaxed);
+}
+
+inline std::uint32_t HistogramBucketOf(std::uint64_t value) {
+  if (value == 0) {
+    return 0;
+  }
+  const std::uint32_t bucket = 64 - static_cast<std::uint32_t>(__builtin_clzll(value));
+  return bucket < kSoMetricsHistogramBuckets ? bucket : kSoMetricsHistogramBuckets - 1;
+}
+
+inline void HistogramObserve(const SoMetric* metric, std::uint64_t value) {
+  SoMetricsHistogramCells& cells = ThreadBuffer()->histograms[metric->index];
+  BumpCell(cells.buckets[HistogramBucketOf(value)], 1);
+  BumpCell(cells.count, 1);
+  BumpCell(cells.sum, value);
+}
+
+}  // namespace so_metrics
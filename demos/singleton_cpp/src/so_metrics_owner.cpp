@@ -0,0 +1,168 @@
+#include "so_metrics_api.h"
+
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace {
+
+const char* KindName(SoMetricKind kind) {
+  switch (kind) {
+    case SO_METRIC_COUNTER:
+      return "counter";
+    case SO_METRIC_GAUGE:
+      return "gauge";
+    case SO_METRIC_HISTOGRAM:
+      return "histogram";
+  }
+  return "untyped";
+}
+
+/*
+ * metrics registry 本体，只存在于 owner so。
+ * - 注册、分配线程缓冲区、导出都走 mu_，都是冷路径。
+ * - 热路径（业务 so 里的 inline 记录函数）只写各自线程的缓冲区，不经过这里。
+ * - 句柄与线程缓冲区故意不释放：业务 so 里缓存的指针在进程退出前都必须有效。
+ */
+class MetricsRegistry final {
+ public:
+  static MetricsRegistry& Instance() {
+    static MetricsRegistry* instance = new MetricsRegistry();
+    return *instance;
+  }
+
+  SoMetric* Register(const char* name, SoMetricKind kind) {
+    if (name == nullptr || name[0] == '\0') {
+      return nullptr;
+    }
+
+    std::lock_guard<std::mutex> lock(mu_);
+    for (auto& entry : entries_) {
+      if (entry->name == name) {
+        return entry->metric.kind == kind ? &entry->metric : nullptr;
+      }
+    }
+
+    std::uint32_t index = 0;
+    if (kind == SO_METRIC_COUNTER) {
+      if (counters_used_ >= kSoMetricsMaxCounters) {
+        return nullptr;
+      }
+      index = counters_used_++;
+    } else if (kind == SO_METRIC_HISTOGRAM) {
+      if (histograms_used_ >= kSoMetricsMaxHistograms) {
+        return nullptr;
+      }
+      index = histograms_used_++;
+    }
+
+    auto entry = std::make_unique<Entry>();
+    entry->name = name;
+    entry->metric.name = entry->name.c_str();
+    entry->metric.kind = kind;
+    entry->metric.index = index;
+    entries_.push_back(std::move(entry));
+    return &entries_.back()->metric;
+  }
+
+  SoMetricsThreadBuffer* ThreadBuffer() {
+    static thread_local SoMetricsThreadBuffer* buffer = nullptr;
+    if (buffer == nullptr) {
+      // 值初始化：所有计数从 0 开始。
+      buffer = new SoMetricsThreadBuffer();
+      std::lock_guard<std::mutex> lock(mu_);
+      buffers_.push_back(buffer);
+    }
+    return buffer;
+  }
+
+  std::string ExportText() {
+    std::lock_guard<std::mutex> lock(mu_);
+    std::string out;
+    for (const auto& entry : entries_) {
+      const SoMetric& metric = entry->metric;
+      out += "# TYPE " + entry->name + " " + KindName(metric.kind) + "\n";
+
+      if (metric.kind == SO_METRIC_COUNTER) {
+        std::uint64_t total = 0;
+        for (const auto* buffer : buffers_) {
+          total += buffer->counters[metric.index].load(std::memory_order_relaxed);
+        }
+        out += entry->name + " " + std::to_string(total) + "\n";
+      } else if (metric.kind == SO_METRIC_GAUGE) {
+        out += entry->name + " " +
+               std::to_string(metric.gauge_value.load(std::memory_order_relaxed)) + "\n";
+      } else {
+        AppendHistogram(entry->name, metric.index, out);
+      }
+    }
+    return out;
+  }
+
+ private:
+  struct Entry {
+    std::string name;
+    SoMetric metric{};
+  };
+
+  MetricsRegistry() = default;
+  MetricsRegistry(const MetricsRegistry&) = delete;
+  MetricsRegistry& operator=(const MetricsRegistry&) = delete;
+
+  void AppendHistogram(const std::string& name, std::uint32_t index, std::string& out) const {
+    std::uint64_t buckets[kSoMetricsHistogramBuckets] = {};
+    std::uint64_t count = 0;
+    std::uint64_t sum = 0;
+    for (const auto* buffer : buffers_) {
+      const SoMetricsHistogramCells& cells = buffer->histograms[index];
+      for (std::uint32_t b = 0; b < kSoMetricsHistogramBuckets; ++b) {
+        buckets[b] += cells.buckets[b].load(std::memory_order_relaxed);
+      }
+      count += cells.count.load(std::memory_order_relaxed);
+      sum += cells.sum.load(std::memory_order_relaxed);
+    }
+
+    // Prometheus 的桶是累积的：le="2^i - 1" 表示所有 <= 该值的观测数。
+    std::uint64_t cumulative = 0;
+    for (std::uint32_t b = 0; b + 1 < kSoMetricsHistogramBuckets; ++b) {
+      cumulative += buckets[b];
+      const std::uint64_t le = (std::uint64_t{1} << b) - 1;
+      out += name + "_bucket{le=\"" + std::to_string(le) + "\"} " +
+             std::to_string(cumulative) + "\n";
+    }
+    cumulative += buckets[kSoMetricsHistogramBuckets - 1];
+    out += name + "_bucket{le=\"+Inf\"} " + std::to_string(cumulative) + "\n";
+    out += name + "_sum " + std::to_string(sum) + "\n";
+    out += name + "_count " + std::to_string(count) + "\n";
+  }
+
+  std::mutex mu_;
+  std::vector<std::unique_ptr<Entry>> entries_;
+  std::vector<SoMetricsThreadBuffer*> buffers_;
+  std::uint32_t counters_used_ = 0;
+  std::uint32_t histograms_used_ = 0;
+};
+
+}  // namespace
+
+extern "C" SINGLETON_DEMO_EXPORT SoMetric* so_metrics_register(const char* name,
+                                                               SoMetricKind kind) {
+  return MetricsRegistry::Instance().Register(name, kind);
+}
+
+extern "C" SINGLETON_DEMO_EXPORT SoMetricsThreadBuffer* so_metrics_thread_buffer() {
+  return MetricsRegistry::Instance().ThreadBuffer();
+}
+
+extern "C" SINGLETON_DEMO_EXPORT std::size_t so_metrics_export(char* buf,
+                                                              std::size_t capacity) {
+  const std::string text = MetricsRegistry::Instance().ExportText();
+  if (buf != nullptr && capacity > 0) {
+    const std::size_t copied = text.size() < capacity - 1 ? text.size() : capacity - 1;
+    std::memcpy(buf, text.data(), copied);
+    buf[copied] = '\0';
+  }
+  return text.size();
+}
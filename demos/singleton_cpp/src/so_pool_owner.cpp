@@ -0,0 +1,307 @@
+#include "so_singleton_api.h"
+
+#include <pthread.h>
+#include <sys/mman.h>
+
+#include <array>
+#include <atomic>
+#include <cstdlib>
+#include <mutex>
+
+namespace {
+
+constexpr std::size_t kSizeClasses[] = {16, 32, 48, 64, 96, 128, 192, 256, 384, 512, 768, 1024};
+constexpr int kNumClasses = static_cast<int>(sizeof(kSizeClasses) / sizeof(kSizeClasses[0]));
+constexpr std::size_t kMaxPooledSize = 1024;
+constexpr std::size_t kSizeGranule = 16;
+// 每次向系统申请的 slab 大小，按 size class 切成等长小块。
+constexpr std::size_t kSlabBytes = 256 * 1024;
+// 线程缓存每个 size class 最多保留的块数；超出时归还一半给中心池。
+constexpr int kThreadCacheMax = 128;
+// 线程缓存为空时一次从中心池取回的块数。
+constexpr int kRefillBatch = 32;
+
+// (size + 15) / 16 -> size class 下标，编译期生成，分配路径上只有一次查表。
+constexpr std::array<std::uint8_t, kMaxPooledSize / kSizeGranule + 1> BuildClassTable() {
+  std::array<std::uint8_t, kMaxPooledSize / kSizeGranule + 1> table{};
+  int cls = 0;
+  for (std::size_t i = 0; i < table.size(); ++i) {
+    while (kSizeClasses[cls] < i * kSizeGranule) {
+      ++cls;
+    }
+    table[i] = static_cast<std::uint8_t>(cls);
+  }
+  return table;
+}
+
+constexpr auto kClassTable = BuildClassTable();
+
+int ClassOf(std::size_t size) {
+  return kClassTable[(size + kSizeGranule - 1) / kSizeGranule];
+}
+
+struct FreeNode {
+  FreeNode* next;
+};
+
+/*
+ * 中心池：每个 size class 一把锁、一条空闲链表、一个 slab 切分游标。
+ * 只在线程缓存补货/溢出时访问，一次搬运一批，锁的摊销成本很低。
+ * slab 通过 mmap 申请，进程生命周期内不归还（池化分配器的常见取舍）。
+ */
+class CentralPool final {
+ public:
+  static CentralPool& Instance() {
+    // 故意不释放：线程退出时的归还、exit 阶段的释放都可能晚于静态对象析构。
+    static CentralPool* instance = new CentralPool();
+    return *instance;
+  }
+
+  // 取最多 want 个块串成链表，返回实际个数。
+  int Fetch(int cls, int want, FreeNode*& head) {
+    ClassPool& pool = pools_[cls];
+    std::lock_guard<std::mutex> lock(pool.mu);
+
+    head = nullptr;
+    int got = 0;
+    while (got < want && pool.free_list != nullptr) {
+      FreeNode* node = pool.free_list;
+      pool.free_list = node->next;
+      node->next = head;
+      head = node;
+      ++got;
+    }
+
+    const std::size_t block = kSizeClasses[cls];
+    while (got < want) {
+      if (pool.bump + block > pool.bump_end && !NewSlab(pool)) {
+        break;
+      }
+      auto* node = reinterpret_cast<FreeNode*>(pool.bump);
+      pool.bump += block;
+      node->next = head;
+      head = node;
+      ++got;
+    }
+    return got;
+  }
+
+  void Return(int cls, FreeNode* head, FreeNode* tail) {
+    ClassPool& pool = pools_[cls];
+    std::lock_guard<std::mutex> lock(pool.mu);
+    tail->next = pool.free_list;
+    pool.free_list = head;
+  }
+
+  std::size_t ReservedBytes() const {
+    return reserved_bytes_.load(std::memory_order_relaxed);
+  }
+
+ private:
+  struct alignas(64) ClassPool {
+    std::mutex mu;
+    FreeNode* free_list = nullptr;
+    char* bump = nullptr;
+    char* bump_end = nullptr;
+  };
+
+  CentralPool() = default;
+  CentralPool(const CentralPool&) = delete;
+  CentralPool& operator=(const CentralPool&) = delete;
+
+  bool NewSlab(ClassPool& pool) {
+    void* slab = ::mmap(nullptr, kSlabBytes, PROT_READ | PROT_WRITE,
+                        MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (slab == MAP_FAILED) {
+      return false;
+    }
+    reserved_bytes_.fetch_add(kSlabBytes, std::memory_order_relaxed);
+    pool.bump = static_cast<char*>(slab);
+    pool.bump_end = pool.bump + kSlabBytes;
+    return true;
+  }
+
+  ClassPool pools_[kNumClasses];
+  std::atomic<std::size_t> reserved_bytes_{0};
+};
+
+/*
+ * 线程缓存：每个 size class 一条无锁单链表。
+ * 分配/释放的快路径只动本线程的链表；线程退出时把缓存整体还给中心池。
+ *
+ * 缓存本身是平凡析构的 thread_local（不挂 C++ TLS 析构），归还由 pthread key 的析构回调完成：
+ * - 业务 so 里的静态容器在 exit 阶段才析构，届时仍会调 so_pool_free；
+ *   C++ 析构的缓存对象在那之前已经销毁，再访问就是未定义行为。
+ * - pthread key 析构在线程的 C++ thread_local 析构之后运行，之后缓存标记为 kDead，
+ *   再来的分配/释放直接走中心池。主线程不运行 key 析构，缓存留到进程结束。
+ */
+class ThreadCache final {
+ public:
+  void* Allocate(int cls) {
+    if (heads_[cls] == nullptr) {
+      counts_[cls] = CentralPool::Instance().Fetch(cls, kRefillBatch, heads_[cls]);
+      if (heads_[cls] == nullptr) {
+        return nullptr;
+      }
+    }
+    FreeNode* node = heads_[cls];
+    heads_[cls] = node->next;
+    --counts_[cls];
+    return node;
+  }
+
+  // 把 [head, tail] 这一串（count 个）挂回本线程缓存，必要时溢出到中心池。
+  void Release(int cls, FreeNode* head, FreeNode* tail, int count) {
+    tail->next = heads_[cls];
+    heads_[cls] = head;
+    counts_[cls] += count;
+    if (counts_[cls] > kThreadCacheMax) {
+      Spill(cls);
+    }
+  }
+
+  // 全部归还中心池。
+  void Flush() {
+    for (int cls = 0; cls < kNumClasses; ++cls) {
+      if (heads_[cls] != nullptr) {
+        CentralPool::Instance().Return(cls, heads_[cls], Tail(heads_[cls]));
+        heads_[cls] = nullptr;
+        counts_[cls] = 0;
+      }
+    }
+  }
+
+ private:
+  static FreeNode* Tail(FreeNode* head) {
+    while (head->next != nullptr) {
+      head = head->next;
+    }
+    return head;
+  }
+
+  // 保留 kThreadCacheMax / 2 个块，其余一次性归还中心池。
+  void Spill(int cls) {
+    FreeNode* keep_tail = heads_[cls];
+    for (int i = 1; i < kThreadCacheMax / 2; ++i) {
+      keep_tail = keep_tail->next;
+    }
+    FreeNode* spill_head = keep_tail->next;
+    keep_tail->next = nullptr;
+    counts_[cls] = kThreadCacheMax / 2;
+    CentralPool::Instance().Return(cls, spill_head, Tail(spill_head));
+  }
+
+  FreeNode* heads_[kNumClasses] = {};
+  int counts_[kNumClasses] = {};
+};
+
+enum class CacheState : unsigned char {
+  kUnregistered,
+  kLive,
+  kDead,
+};
+
+// 常量初始化 + 平凡析构 + initial-exec：访问时没有 TLS guard，也不走 __tls_get_addr。
+thread_local ThreadCache t_cache __attribute__((tls_model("initial-exec")));
+thread_local CacheState t_cache_state __attribute__((tls_model("initial-exec"))) =
+    CacheState::kUnregistered;
+
+void FlushOnThreadExit(void*) {
+  t_cache.Flush();
+  t_cache_state = CacheState::kDead;
+}
+
+pthread_key_t CacheKey() {
+  static const pthread_key_t key = [] {
+    pthread_key_t created{};
+    ::pthread_key_create(&created, &FlushOnThreadExit);
+    return created;
+  }();
+  return key;
+}
+
+// 线程已走完退出清理时返回 nullptr，调用方改为直接访问中心池。
+ThreadCache* LocalCache() {
+  if (t_cache_state == CacheState::kLive) {
+    return &t_cache;
+  }
+  if (t_cache_state == CacheState::kDead) {
+    return nullptr;
+  }
+  // 值必须非空，线程退出时析构回调才会被调用。
+  ::pthread_setspecific(CacheKey(), &t_cache);
+  t_cache_state = CacheState::kLive;
+  return &t_cache;
+}
+
+void* AllocateBlock(int cls) {
+  if (ThreadCache* cache = LocalCache()) {
+    return cache->Allocate(cls);
+  }
+  FreeNode* head = nullptr;
+  CentralPool::Instance().Fetch(cls, 1, head);
+  return head;
+}
+
+void ReleaseBlocks(int cls, FreeNode* head, FreeNode* tail, int count) {
+  if (ThreadCache* cache = LocalCache()) {
+    cache->Release(cls, head, tail, count);
+    return;
+  }
+  CentralPool::Instance().Return(cls, head, tail);
+}
+
+}  // namespace
+
+extern "C" SINGLETON_DEMO_EXPORT void* so_pool_alloc(std::size_t size) {
+  if (size > kMaxPooledSize) {
+    return std::malloc(size);
+  }
+  return AllocateBlock(ClassOf(size == 0 ? 1 : size));
+}
+
+extern "C" SINGLETON_DEMO_EXPORT void so_pool_free(void* ptr, std::size_t size) {
+  if (ptr == nullptr) {
+    return;
+  }
+  if (size > kMaxPooledSize) {
+    std::free(ptr);
+    return;
+  }
+  auto* node = static_cast<FreeNode*>(ptr);
+  ReleaseBlocks(ClassOf(size == 0 ? 1 : size), node, node, 1);
+}
+
+extern "C" SINGLETON_DEMO_EXPORT void so_pool_free_bulk(void* const* ptrs, std::size_t count,
+                                                        std::size_t size) {
+  if (size > kMaxPooledSize) {
+    for (std::size_t i = 0; i < count; ++i) {
+      std::free(ptrs[i]);
+    }
+    return;
+  }
+
+  // 先在本地串成一条链，再一次性挂回线程缓存：count 次释放只做一次溢出检查。
+  FreeNode* head = nullptr;
+  FreeNode* tail = nullptr;
+  int linked = 0;
+  for (std::size_t i = 0; i < count; ++i) {
+    if (ptrs[i] == nullptr) {
+      continue;
+    }
+    auto* node = static_cast<FreeNode*>(ptrs[i]);
+    node->next = head;
+    head = node;
+    if (tail == nullptr) {
+      tail = node;
+    }
+    ++linked;
+  }
+  if (head != nullptr) {
+    ReleaseBlocks(ClassOf(size == 0 ? 1 : size), head, tail, linked);
+  }
+}
+
+extern "C" SINGLETON_DEMO_EXPORT std::size_t so_pool_reserved_bytes() {
+  return CentralPool::Instance().ReservedBytes();
+}
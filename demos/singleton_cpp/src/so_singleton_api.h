@@ -1,6 +1,8 @@
 #pragma once
 
+#include <cstddef>
 #include <cstdint>
+#include <new>
 
 #include "singleton_export.h"
 
@@ -9,6 +11,8 @@ struct ConsumerSnapshot {
   std::uintptr_t local_singleton_addr;
   std::uintptr_t exported_singleton_addr;
   int exported_value;
+  // consumer 本地保存的最近 exported_value 个数（链表节点来自 owner 的对象池）。
+  std::size_t pooled_history_size;
 };
 
 extern "C" {
@@ -16,7 +20,73 @@ extern "C" {
 SINGLETON_DEMO_EXPORT int* so_singleton_instance();
 SINGLETON_DEMO_EXPORT int so_singleton_next();
 
+// 分片计数器：高并发下只需累加、偶尔读总数的场景用它替代 so_singleton_next()。
+// 快速累加：按线程固定分片（首次调用时分配），无锁、无共享 cache line。
+SINGLETON_DEMO_EXPORT void so_counter_add(std::int64_t delta);
+// 快速累加：按当前 CPU 选分片（sched_getcpu，glibc 2.35+ 走 rseq 快路径）。
+SINGLETON_DEMO_EXPORT void so_counter_add_percpu(std::int64_t delta);
+// 精确读：汇总所有分片，调用前已完成的累加都会被计入。
+SINGLETON_DEMO_EXPORT std::int64_t so_counter_read_exact();
+
+// 进程级小对象池：size class（16..1024 字节）+ 每线程缓存 + 中心池批量搬运，大于 1024 字节退回 malloc。
+// 释放时必须传入分配时的 size（sized free，省去块头查找）。
+SINGLETON_DEMO_EXPORT void* so_pool_alloc(std::size_t size);
+SINGLETON_DEMO_EXPORT void so_pool_free(void* ptr, std::size_t size);
+// 批量释放 count 个同样 size 的块，只做一次线程缓存溢出检查；ptrs 中的 nullptr 会被跳过。
+SINGLETON_DEMO_EXPORT void so_pool_free_bulk(void* const* ptrs, std::size_t count,
+                                             std::size_t size);
+// 池已向系统申请的 slab 总字节数。
+SINGLETON_DEMO_EXPORT std::size_t so_pool_reserved_bytes();
+
+// 进程级 work-stealing 线程池：每个 worker 一个双端队列，空闲时互相偷任务，没活时 park。
+// 所有业务 so 共用同一组 worker，不再各自临时起线程。
+typedef void (*SoTaskFn)(void* arg);
+typedef void (*SoIndexedTaskFn)(void* arg, int index);
+// 在首次使用前调用才生效（否则返回 -1）。workers <= 0 表示按 CPU 数；pin_cores 非 0 时把 worker i 绑到 CPU i。
+SINGLETON_DEMO_EXPORT int so_executor_configure(int workers, int pin_cores);
+SINGLETON_DEMO_EXPORT int so_executor_worker_count();
+// 提交一个任务后立即返回；调用方自行保证 arg 在任务执行期间有效。
+SINGLETON_DEMO_EXPORT void so_executor_submit(SoTaskFn fn, void* arg);
+// fork/join：对 [0, tasks) 每个下标执行一次 fn(arg, index)，全部完成后返回。
+// 调用线程会亲自执行下标 0 并在等待时帮忙偷任务，因此在 worker 内嵌套调用也不会死锁。
+SINGLETON_DEMO_EXPORT void so_executor_parallel_for(int tasks, SoIndexedTaskFn fn, void* arg);
+
 SINGLETON_DEMO_EXPORT ConsumerSnapshot consumer_one_snapshot();
 SINGLETON_DEMO_EXPORT ConsumerSnapshot consumer_two_snapshot();
 
+// 在 consumer_one 内部连续记录 iterations 次 metrics，供 metrics_bench 测量“so 内记录成本”。
+// mode：0=counter，1=gauge，2=histogram，3=每次跨 so 调用 so_counter_add（对照组）。
+SINGLETON_DEMO_EXPORT void consumer_one_record_metrics(int mode, std::uint64_t iterations);
+
 }  // extern "C"
+
+// 让标准容器从 owner 的对象池分配（例如 std::list 节点），各业务 so 共用同一个池。
+template <typename T>
+struct SoPoolAllocator {
+  using value_type = T;
+
+  SoPoolAllocator() noexcept = default;
+  template <typename U>
+  SoPoolAllocator(const SoPoolAllocator<U>&) noexcept {}
+
+  T* allocate(std::size_t n) {
+    void* ptr = so_pool_alloc(n * sizeof(T));
+    if (ptr == nullptr) {
+      throw std::bad_alloc();
+    }
+    return static_cast<T*>(ptr);
+  }
+
+  void deallocate(T* ptr, std::size_t n) noexcept {
+    so_pool_free(ptr, n * sizeof(T));
+  }
+
+  template <typename U>
+  bool operator==(const SoPoolAllocator<U>&) const noexcept {
+    return true;
+  }
+  template <typename U>
+  bool operator!=(const SoPoolAllocator<U>&) const noexcept {
+    return false;
+  }
+};
@@ -1,9 +1,15 @@
 #include "so_singleton_api.h"
 
+#include <sched.h>
+
+#include <atomic>
 #include <mutex>
 
 namespace {
 
+constexpr int kCounterShards = 64;
+constexpr std::size_t kCacheLine = 64;
+
 class SoSingleton final {
  public:
   static SoSingleton& Instance() {
@@ -30,6 +36,60 @@ class SoSingleton final {
   std::mutex mu_;
 };
 
+/*
+ * 分片计数器：每个分片独占一个 cache line。
+ * - 累加只落到一个分片，线程之间不再争抢同一个 cache line；
+ *   分片数有限，多个线程可能共用一个分片，所以仍用 relaxed fetch_add，但基本无竞争。
+ * - 精确读遍历所有分片求和，成本 O(分片数)，适合“写多读少”。
+ */
+class ShardedCounter final {
+ public:
+  static ShardedCounter& Instance() {
+    static ShardedCounter instance;
+    return instance;
+  }
+
+  void AddToThreadShard(std::int64_t delta) {
+    // 常量初始化 + initial-exec：owner 随进程启动加载，TLS 访问不必走 __tls_get_addr。
+    static thread_local int shard __attribute__((tls_model("initial-exec"))) = -1;
+    if (shard < 0) {
+      shard = next_thread_shard_.fetch_add(1, std::memory_order_relaxed) % kCounterShards;
+    }
+    shards_[shard].value.fetch_add(delta, std::memory_order_relaxed);
+  }
+
+  void AddToCpuShard(std::int64_t delta) {
+    const int cpu = ::sched_getcpu();
+    // sched_getcpu 失败时退回按线程分片。
+    if (cpu < 0) {
+      AddToThreadShard(delta);
+      return;
+    }
+    shards_[cpu % kCounterShards].value.fetch_add(delta, std::memory_order_relaxed);
+  }
+
+  std::int64_t ReadExact() const {
+    std::int64_t sum = 0;
+    for (const auto& shard : shards_) {
+      sum += shard.value.load(std::memory_order_acquire);
+    }
+    return sum;
+  }
+
+ private:
+  struct alignas(kCacheLine) Shard {
+    std::atomic<std::int64_t> value{0};
+  };
+
+  ShardedCounter() = default;
+  ~ShardedCounter() = default;
+  ShardedCounter(const ShardedCounter&) = delete;
+  ShardedCounter& operator=(const ShardedCounter&) = delete;
+
+  Shard shards_[kCounterShards];
+  std::atomic<int> next_thread_shard_{0};
+};
+
 }  // namespace
 
 extern "C" SINGLETON_DEMO_EXPORT int* so_singleton_instance() {
@@ -39,3 +99,15 @@ extern "C" SINGLETON_DEMO_EXPORT int* so_singleton_instance() {
 extern "C" SINGLETON_DEMO_EXPORT int so_singleton_next() {
   return SoSingleton::Instance().Next();
 }
+
+extern "C" SINGLETON_DEMO_EXPORT void so_counter_add(std::int64_t delta) {
+  ShardedCounter::Instance().AddToThreadShard(delta);
+}
+
+extern "C" SINGLETON_DEMO_EXPORT void so_counter_add_percpu(std::int64_t delta) {
+  ShardedCounter::Instance().AddToCpuShard(delta);
+}
+
+extern "C" SINGLETON_DEMO_EXPORT std::int64_t so_counter_read_exact() {
+  return ShardedCounter::Instance().ReadExact();
+}